@@ -0,0 +1,10 @@
+#ifndef ALLOCATION_COUNTER_H_
+#define ALLOCATION_COUNTER_H_
+
+#include <cstdint>
+
+//Linking AllocationCounter.cpp into a program replaces every form of the global operator new and delete with ones that count each allocation,
+//so that searches can be compared by how many they make
+std::uint64_t getAllocationCount();
+
+#endif
@@ -0,0 +1,911 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <unordered_set>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "TicTacToe.hpp"
+#include "StaticTicTacToe.hpp"
+#include "ConnectFour.hpp"
+#include "MctsSearch.hpp"
+#include "BenchmarkCorpus.hpp"
+#include "AllocationCounter.hpp"
+
+namespace
+{
+  struct Result
+  {
+    std::uint64_t nodes;
+    double seconds;
+    int value;
+  };
+
+  template <typename Search>
+  Result timeSearch(Search& search, int repetitions)
+  {
+    Result result = {0, 0.0, 0};
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < repetitions; ++i)
+    {
+      result.value = search();
+      result.nodes += search.nodes();
+    }
+    auto finish = std::chrono::high_resolution_clock::now();
+    result.seconds = std::chrono::duration<double>(finish - start).count();
+    return result;
+  }
+
+  void printResult(const std::string& engine, const std::string& mode, const Result& result)
+  {
+    std::cout << std::left << std::setw(30) << engine << std::setw(12) << mode
+              << std::right << std::setw(12) << result.nodes
+              << std::setw(12) << std::fixed << std::setprecision(4) << result.seconds
+              << std::setw(16) << std::setprecision(0) << result.nodes / result.seconds
+              << std::setw(8) << result.value << std::endl;
+  }
+
+  //TicTacToe searched through successorStates instead of in place, to compare the two
+  class SuccessorStatesTicTacToe : public TicTacToe
+  {
+  public:
+    bool supportsInPlaceMoves() const override { return false; }
+  };
+
+  //Counts the successor states a search builds - either all of a node's at once from successorStates or, when lazy, one at a time from nextSuccessor
+  class CountingTicTacToe : public SuccessorStatesTicTacToe
+  {
+  public:
+    CountingTicTacToe(bool lazy) : lazy(lazy), statesBuilt(0) {}
+
+    std::vector<std::pair<std::shared_ptr<State>, std::shared_ptr<Action>>> successorStates(const std::shared_ptr<State>& state) const override
+    {
+      std::vector<std::pair<std::shared_ptr<State>, std::shared_ptr<Action>>> successors = TicTacToe::successorStates(state);
+      statesBuilt += successors.size();
+      return successors;
+    }
+
+    bool nextSuccessor(const std::shared_ptr<State>& state, SuccessorCursor& cursor, std::pair<std::shared_ptr<State>, std::shared_ptr<Action>>& successor) const override
+    {
+      if (!lazy)
+        return SearchableGame::nextSuccessor(state, cursor, successor);
+
+      bool produced = TicTacToe::nextSuccessor(state, cursor, successor);
+      if (produced)
+        statesBuilt++;
+      return produced;
+    }
+
+    std::uint64_t getStatesBuilt() const { return statesBuilt; }
+    void resetStatesBuilt() { statesBuilt = 0; }
+
+  private:
+    bool lazy;
+    mutable std::atomic<std::uint64_t> statesBuilt;
+  };
+
+  //States built and allocations made by the pruning search when successors are built up front and when they are produced lazily
+  void compareSuccessorGeneration()
+  {
+    const std::vector<std::pair<std::string, std::array<char, 9>>> positions = {
+      {"empty", {'-', '-', '-', '-', '-', '-', '-', '-', '-'}},
+      {"midgame", {'X', '-', '-', '-', 'O', '-', '-', '-', 'X'}}
+    };
+
+    std::cout << std::endl << std::left << std::setw(14) << "position" << std::setw(12) << "successors"
+              << std::right << std::setw(12) << "nodes" << std::setw(14) << "states built" << std::setw(14) << "allocations" << std::setw(12) << "seconds" << std::endl;
+
+    for (const auto& position : positions)
+    {
+      for (bool lazy : {false, true})
+      {
+        std::shared_ptr<CountingTicTacToe> game = std::make_shared<CountingTicTacToe>(lazy);
+        MiniMaxSearch search(game, 1);
+        std::shared_ptr<State> state = std::make_shared<TicTacToeState>(position.second);
+        const std::vector<MiniMaxSearch::Options> options = {MiniMaxSearch::Options::USE_PRUNING};
+
+        game->resetStatesBuilt();
+        std::uint64_t allocationsBefore = getAllocationCount();
+        auto start = std::chrono::high_resolution_clock::now();
+        search.performSearch(state, options);
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        std::cout << std::left << std::setw(14) << position.first << std::setw(12) << (lazy ? "lazy" : "up front")
+                  << std::right << std::setw(12) << search.getNodesVisited() << std::setw(14) << game->getStatesBuilt()
+                  << std::setw(14) << getAllocationCount() - allocationsBefore
+                  << std::setw(12) << std::fixed << std::setprecision(4) << seconds << std::endl;
+      }
+    }
+  }
+
+  //Heap allocations, search throughput and memory with and without the search arena - both build the same states and actions
+  //Each search runs in a child process, whose peak RSS starts out at the resident size of this process when it forks,
+  //so the searches' memory is how far the child's peak grew while searching, next to the memory the arena itself held and reserved
+  void compareSearchArena(int repetitions)
+  {
+    std::shared_ptr<SearchableGame> game = std::make_shared<SuccessorStatesTicTacToe>();
+
+    std::cout << std::endl << std::left << std::setw(12) << "memory" << std::setw(12) << "mode"
+              << std::right << std::setw(12) << "nodes" << std::setw(14) << "heap allocs"
+              << std::setw(12) << "seconds" << std::setw(16) << "nodes/sec" << std::setw(16) << "rss growth kb"
+              << std::setw(16) << "arena peak kb" << std::setw(18) << "arena blocks kb" << std::endl;
+
+    for (bool pruning : {false, true})
+    {
+      for (bool arena : {false, true})
+      {
+        std::vector<MiniMaxSearch::Options> options;
+        if (pruning)
+          options.push_back(MiniMaxSearch::Options::USE_PRUNING);
+        if (arena)
+          options.push_back(MiniMaxSearch::Options::USE_SEARCH_ARENA);
+
+        std::cout.flush();
+        pid_t child = fork();
+        if (child == 0)
+        {
+          MiniMaxSearch search(game, 1);
+          rusage usageBefore = {};
+          getrusage(RUSAGE_SELF, &usageBefore);
+
+          std::uint64_t nodes = 0;
+          std::uint64_t allocationsBefore = getAllocationCount();
+          auto start = std::chrono::high_resolution_clock::now();
+          for (int i = 0; i < repetitions; ++i)
+          {
+            search.performSearch(game->getState(), options);
+            nodes += search.getNodesVisited();
+          }
+          double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+          std::uint64_t allocations = getAllocationCount() - allocationsBefore;
+
+          rusage usageAfter = {};
+          getrusage(RUSAGE_SELF, &usageAfter);
+
+          std::cout << std::left << std::setw(12) << (arena ? "arena" : "heap") << std::setw(12) << (pruning ? "pruning" : "minimax")
+                    << std::right << std::setw(12) << nodes / repetitions << std::setw(14) << allocations / repetitions
+                    << std::setw(12) << std::fixed << std::setprecision(4) << seconds / repetitions
+                    << std::setw(16) << std::setprecision(0) << nodes / seconds
+                    << std::setw(16) << usageAfter.ru_maxrss - usageBefore.ru_maxrss
+                    << std::setw(16) << search.getSearchArenaPeakBytes() / 1024
+                    << std::setw(18) << search.getSearchArenaBytesReserved() / 1024 << std::endl;
+          _exit(0);
+        }
+
+        int status = 0;
+        waitpid(child, &status, 0);
+      }
+    }
+  }
+
+  template <typename Engine, typename StateType, typename OptionsType>
+  struct SearchRunner
+  {
+    Engine& engine;
+    StateType state;
+    std::vector<OptionsType> options;
+
+    int operator()()
+    {
+      //every repetition starts from an empty transposition table rather than the one the last left behind
+      if constexpr (requires { engine.newGame(); })
+        engine.newGame();
+      return engine.performSearch(state, options).value;
+    }
+    std::uint64_t nodes() const { return engine.getNodesVisited(); }
+  };
+
+  //Node counts for the iterative deepening pruning searches as each search feature is added on a few positions
+  void compareSearchFeatures(const std::shared_ptr<SearchableGame>& game)
+  {
+    const std::vector<std::pair<std::string, std::array<char, 9>>> positions = {
+      {"empty", {'-', '-', '-', '-', '-', '-', '-', '-', '-'}},
+      {"corner", {'X', '-', '-', '-', '-', '-', '-', '-', '-'}},
+      {"edge-reply", {'X', '-', '-', '-', '-', '-', '-', 'O', '-'}},
+      {"midgame", {'X', '-', '-', '-', 'O', '-', '-', '-', 'X'}}
+    };
+
+    const std::vector<MiniMaxSearch::Options> features = {
+      MiniMaxSearch::Options::USE_MOVE_ORDERING,
+      MiniMaxSearch::Options::USE_PRINCIPAL_VARIATION_SEARCH,
+      MiniMaxSearch::Options::USE_ASPIRATION_WINDOWS
+    };
+
+    MiniMaxSearch search(game);
+
+    std::cout << std::endl << std::left << std::setw(14) << "position" << std::setw(16) << "mode"
+              << std::right << std::setw(12) << "base" << std::setw(12) << "+ordering" << std::setw(12) << "+pvs" << std::setw(12) << "+aspiration" << std::endl;
+
+    for (const auto& position : positions)
+    {
+      std::shared_ptr<State> state = std::make_shared<TicTacToeState>(position.second);
+      for (bool transpositionTable : {false, true})
+      {
+        std::vector<MiniMaxSearch::Options> options = {MiniMaxSearch::Options::USE_PRUNING};
+        if (transpositionTable)
+          options.push_back(MiniMaxSearch::Options::USE_TRANSPOSITION_TABLE);
+
+        std::cout << std::left << std::setw(14) << position.first << std::setw(16) << (transpositionTable ? "id+pruning+tt" : "id+pruning") << std::right;
+
+        search.newGame();
+        search.performSearch(state, options, MiniMaxSearch::Limits());
+        std::cout << std::setw(12) << search.getNodesVisited();
+        for (MiniMaxSearch::Options feature : features)
+        {
+          options.push_back(feature);
+          search.newGame();
+          search.performSearch(state, options, MiniMaxSearch::Limits());
+          std::cout << std::setw(12) << search.getNodesVisited();
+        }
+        std::cout << std::endl;
+      }
+    }
+  }
+
+  //Lazy SMP scaling - time to finish the iterative deepening search and nodes per second for increasing thread counts
+  void compareThreadCounts(const std::shared_ptr<SearchableGame>& game, int repetitions)
+  {
+    //lazy SMP shares the transposition table between independent searches while young brothers wait splits up the pruning search itself
+    //with one thread both are the serial pruning search
+    const std::vector<std::pair<std::string, std::vector<MiniMaxSearch::Options>>> parallelSearches = {
+      {"lazy smp", {MiniMaxSearch::Options::USE_PRUNING, MiniMaxSearch::Options::USE_TRANSPOSITION_TABLE, MiniMaxSearch::Options::USE_MOVE_ORDERING}},
+      {"young brothers", {MiniMaxSearch::Options::USE_PRUNING, MiniMaxSearch::Options::USE_TRANSPOSITION_TABLE, MiniMaxSearch::Options::USE_MOVE_ORDERING, MiniMaxSearch::Options::USE_YOUNG_BROTHERS_WAIT}},
+      {"young brothers no tt", {MiniMaxSearch::Options::USE_PRUNING, MiniMaxSearch::Options::USE_YOUNG_BROTHERS_WAIT}}
+    };
+
+    MiniMaxSearch search(game);
+
+    std::cout << std::endl << std::left << std::setw(22) << "parallelism" << std::setw(10) << "threads"
+              << std::right << std::setw(12) << "nodes" << std::setw(16) << "time-to-depth" << std::setw(16) << "nodes/sec" << std::setw(8) << "value" << std::endl;
+
+    for (const auto& [name, options] : parallelSearches)
+    {
+      for (int threadCount : {1, 2, 4, 8})
+      {
+        std::uint64_t nodes = 0;
+        int value = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < repetitions; ++i)
+        {
+          search.newGame();
+          value = search.performSearch(game->getState(), options, MiniMaxSearch::Limits(), threadCount).value;
+          nodes += search.getNodesVisited();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        std::cout << std::left << std::setw(22) << name << std::setw(10) << threadCount
+                  << std::right << std::setw(12) << nodes / repetitions
+                  << std::setw(16) << std::fixed << std::setprecision(6) << seconds / repetitions
+                  << std::setw(16) << std::setprecision(0) << nodes / seconds << std::setw(8) << value << std::endl;
+      }
+    }
+  }
+
+  //Nodes searched on each move and total time to move through a line of play, keeping the transposition table from move to move or starting each move with newGame
+  //both search the same positions, whatever they would have chosen themselves
+  void compareMoveTimes(const std::string& name, const std::shared_ptr<SearchableGame>& game, const std::vector<std::shared_ptr<State>>& positions,
+    const std::vector<MiniMaxSearch::Options>& options, const MiniMaxSearch::Limits& limits)
+  {
+    std::cout << std::endl << std::left << std::setw(30) << name << std::right;
+    for (std::size_t move = 0; move < positions.size(); ++move)
+      std::cout << std::setw(9) << "move " + std::to_string(move + 1);
+    std::cout << std::setw(12) << "seconds" << std::endl;
+
+    for (bool keepTable : {false, true})
+    {
+      MiniMaxSearch search(game);
+      double seconds = 0.0;
+      std::cout << std::left << std::setw(30) << (keepTable ? "kept table" : "new table each move") << std::right;
+      for (const std::shared_ptr<State>& position : positions)
+      {
+        if (!keepTable)
+          search.newGame();
+        auto start = std::chrono::high_resolution_clock::now();
+        search.performSearch(position, options, limits);
+        seconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        std::cout << std::setw(9) << search.getNodesVisited();
+      }
+      std::cout << std::setw(12) << std::fixed << std::setprecision(4) << seconds << std::endl;
+    }
+  }
+
+  void compareMoveTimes()
+  {
+    typedef MiniMaxSearch::Options Options;
+    const std::vector<Options> options = {Options::USE_PRUNING, Options::USE_TRANSPOSITION_TABLE, Options::USE_MOVE_ORDERING, Options::USE_PRINCIPAL_VARIATION_SEARCH};
+
+    //every move of a tic-tac-toe game searched to the end, where the table from earlier moves already holds exact values for most of the tree
+    std::shared_ptr<TicTacToe> ticTacGame = std::make_shared<TicTacToe>();
+    std::vector<std::shared_ptr<State>> ticTacPositions;
+    {
+      TicTacToe line;
+      MiniMaxSearch lineSearch(ticTacGame);
+      while (!line.checkEndOfGame())
+      {
+        ticTacPositions.push_back(line.getState());
+        line.makeMove(std::dynamic_pointer_cast<TicTacToeAction>(lineSearch.performSearch(line.getState(), options).action)->cell);
+      }
+    }
+    compareMoveTimes("tic-tac-toe to the end", ticTacGame, ticTacPositions, options, MiniMaxSearch::Limits());
+
+    //one side's first moves of a connect four game searched to a fixed depth, where the table from the last move is two plies too shallow to settle the new root
+    //so mostly helps the early iterations and the move ordering
+    std::shared_ptr<ConnectFour> connectFourGame = std::make_shared<ConnectFour>();
+    std::vector<std::shared_ptr<State>> connectFourPositions;
+    {
+      ConnectFour line;
+      MiniMaxSearch lineSearch(connectFourGame);
+      for (int move = 0; move < 16; ++move)
+      {
+        if (move % 2 == 0)
+          connectFourPositions.push_back(line.getState());
+        line.makeMove(std::dynamic_pointer_cast<ConnectFourAction>(lineSearch.performSearch(line.getState(), options, 6).action)->column);
+      }
+    }
+    MiniMaxSearch::Limits limits;
+    limits.depth = 12;
+    compareMoveTimes("connect four to depth 12", connectFourGame, connectFourPositions, options, limits);
+  }
+
+  //Throughput of searchBatch on a batch of connect four positions a few moves into the game, with and without a transposition table shared across the batch
+  void compareBatchSearch(int repetitions)
+  {
+    //the positions come from a fixed sequence of pseudo random moves so every run searches the same batch
+    std::vector<std::shared_ptr<State>> states;
+    std::uint32_t seed = 12345;
+    while (states.size() < 200)
+    {
+      ConnectFour connectFourGame;
+      for (int move = 0; move < 8 && !connectFourGame.checkEndOfGame(); ++move)
+      {
+        seed = seed * 1664525u + 1013904223u;
+        int column = (seed >> 16) % ConnectFourBoard::COLUMNS;
+        try
+        {
+          connectFourGame.makeMove(column);
+        }
+        catch (ConnectFour::ConnectFourInvalidMoveException& e) {}
+      }
+      if (!connectFourGame.checkEndOfGame())
+        states.push_back(connectFourGame.getState());
+    }
+
+    const std::vector<MiniMaxSearch::Options> options = {MiniMaxSearch::Options::USE_PRUNING, MiniMaxSearch::Options::USE_TRANSPOSITION_TABLE, MiniMaxSearch::Options::USE_MOVE_ORDERING};
+    MiniMaxSearch::Limits limits;
+    limits.depth = 7;
+    MiniMaxSearch search(std::make_shared<ConnectFour>());
+
+    std::cout << std::endl << std::left << std::setw(22) << "batch of " + std::to_string(states.size()) << std::setw(10) << "threads"
+              << std::right << std::setw(12) << "nodes" << std::setw(12) << "seconds" << std::setw(16) << "positions/sec" << std::setw(16) << "nodes/sec" << std::endl;
+
+    for (bool shareTranspositionTable : {false, true})
+    {
+      for (int threadCount : {1, 2, 4})
+      {
+        std::uint64_t nodes = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < repetitions; ++i)
+        {
+          search.searchBatch(states, options, limits, threadCount, shareTranspositionTable);
+          nodes += search.getNodesVisited();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+        std::cout << std::left << std::setw(22) << (shareTranspositionTable ? "shared tt" : "tt per thread") << std::setw(10) << threadCount
+                  << std::right << std::setw(12) << nodes / repetitions
+                  << std::setw(12) << std::fixed << std::setprecision(4) << seconds / repetitions
+                  << std::setw(16) << std::setprecision(0) << states.size() * repetitions / seconds
+                  << std::setw(16) << nodes / seconds << std::endl;
+      }
+    }
+  }
+
+  //Depth limited tic-tac-toe searches evaluating the leaves one at a time through getEvaluationValue and in batches with TicTacToe's SIMD evaluateBatch,
+  //both in place and through successorStates - the nodes and values are the same either way
+  void compareBatchEvaluation(int repetitions)
+  {
+    typedef MiniMaxSearch::Options Options;
+    const std::vector<std::pair<std::string, std::shared_ptr<SearchableGame>>> games = {
+      {"in place", std::make_shared<TicTacToe>()},
+      {"successors", std::make_shared<SuccessorStatesTicTacToe>()}
+    };
+
+    std::cout << std::endl << std::left << std::setw(14) << "leaf eval" << std::setw(12) << "moves" << std::setw(8) << "depth"
+              << std::right << std::setw(12) << "nodes" << std::setw(12) << "seconds" << std::setw(16) << "nodes/sec" << std::setw(8) << "value" << std::endl;
+
+    for (int depth : {4, 6})
+    {
+      for (const auto& [name, game] : games)
+      {
+        for (bool batch : {false, true})
+        {
+          std::vector<Options> options = {Options::USE_PRUNING, Options::USE_MOVE_ORDERING};
+          if (batch)
+            options.push_back(Options::USE_BATCH_EVALUATION);
+
+          MiniMaxSearch search(game, 1);
+          std::uint64_t nodes = 0;
+          int value = 0;
+          auto start = std::chrono::high_resolution_clock::now();
+          for (int i = 0; i < repetitions * 20; ++i)
+          {
+            value = search.performSearch(game->getState(), options, depth).value;
+            nodes += search.getNodesVisited();
+          }
+          double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+          std::cout << std::left << std::setw(14) << (batch ? "batch" : "per node") << std::setw(12) << name << std::setw(8) << depth
+                    << std::right << std::setw(12) << nodes / (repetitions * 20)
+                    << std::setw(12) << std::fixed << std::setprecision(5) << seconds / (repetitions * 20)
+                    << std::setw(16) << std::setprecision(0) << nodes / seconds << std::setw(8) << value << std::endl;
+        }
+      }
+    }
+  }
+
+  //Checks the tic-tac-toe oracle against MiniMaxSearch searching every legal position with a move to make to the end, and compares how long each takes to choose
+  //The oracle is solved during compilation so it is the ground truth - returns false when the search gets any position's value wrong
+  bool compareOracle()
+  {
+    std::shared_ptr<TicTacToe> ticTacGame = std::make_shared<TicTacToe>();
+    std::vector<std::shared_ptr<State>> positions;
+    std::vector<std::shared_ptr<State>> unexplored = {ticTacGame->getState()};
+    std::unordered_set<std::uint64_t> seen;
+    while (!unexplored.empty())
+    {
+      std::shared_ptr<State> state = unexplored.back();
+      unexplored.pop_back();
+      if (!seen.insert(static_cast<const TicTacToeState&>(*state).board.hash).second || ticTacGame->terminalState(state))
+        continue;
+      positions.push_back(state);
+      for (const auto& successor : ticTacGame->successorStates(state))
+        unexplored.push_back(successor.first);
+    }
+
+    const std::vector<MiniMaxSearch::Options> options = {MiniMaxSearch::Options::USE_PRUNING, MiniMaxSearch::Options::USE_TRANSPOSITION_TABLE};
+    MiniMaxSearch search(ticTacGame);
+    int disagreements = 0;
+    double searchSeconds = 0;
+    double oracleSeconds = 0;
+    for (const std::shared_ptr<State>& state : positions)
+    {
+      search.newGame();
+      auto start = std::chrono::high_resolution_clock::now();
+      int searchValue = search.performSearch(state, options).value;
+      auto searched = std::chrono::high_resolution_clock::now();
+      int oracleValue = ticTacGame->getOracleMove(state).value;
+      auto looked = std::chrono::high_resolution_clock::now();
+      searchSeconds += std::chrono::duration<double>(searched - start).count();
+      oracleSeconds += std::chrono::duration<double>(looked - searched).count();
+      if (searchValue != oracleValue)
+        disagreements++;
+    }
+
+    std::cout << std::endl << std::left << std::setw(22) << "tic-tac-toe oracle" << std::right << std::setw(12) << "positions" << std::setw(16) << "disagreements"
+              << std::setw(20) << "search us/move" << std::setw(20) << "oracle us/move" << std::endl;
+    std::cout << std::left << std::setw(22) << "every position" << std::right << std::setw(12) << positions.size() << std::setw(16) << disagreements
+              << std::setw(20) << std::fixed << std::setprecision(3) << 1e6 * searchSeconds / positions.size()
+              << std::setw(20) << 1e6 * oracleSeconds / positions.size() << std::endl;
+    return disagreements == 0;
+  }
+
+  //A connect four search from the empty board in a new process with a cold table against one starting from the position cache an earlier process left
+  //the restarted search is a new MiniMaxSearch so only the cache carries anything over
+  void compareWarmStart()
+  {
+    typedef MiniMaxSearch::Options Options;
+    const std::vector<Options> options = {Options::USE_PRUNING, Options::USE_TRANSPOSITION_TABLE, Options::USE_MOVE_ORDERING, Options::USE_PRINCIPAL_VARIATION_SEARCH};
+    MiniMaxSearch::Limits limits;
+    limits.depth = 12;
+    std::shared_ptr<ConnectFour> connectFourGame = std::make_shared<ConnectFour>();
+    std::string path = (std::filesystem::temp_directory_path() / "minimax_bench_positions.cache").string();
+
+    std::cout << std::endl << std::left << std::setw(22) << "connect four depth 12" << std::right << std::setw(12) << "nodes" << std::setw(12) << "seconds" << std::setw(8) << "value" << std::endl;
+    auto printRow = [](const std::string& name, std::uint64_t nodes, double seconds, int value)
+    {
+      std::cout << std::left << std::setw(22) << name << std::right << std::setw(12) << nodes
+                << std::setw(12) << std::fixed << std::setprecision(4) << seconds << std::setw(8) << value << std::endl;
+    };
+
+    {
+      MiniMaxSearch coldSearch(connectFourGame);
+      auto start = std::chrono::high_resolution_clock::now();
+      int value = coldSearch.performSearch(connectFourGame->getState(), options, limits).value;
+      printRow("cold", coldSearch.getNodesVisited(), std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count(), value);
+      coldSearch.savePositionCache(path);
+    }
+
+    MiniMaxSearch warmSearch(connectFourGame);
+    auto start = std::chrono::high_resolution_clock::now();
+    warmSearch.setPositionCache(std::make_shared<PositionCache>(path));
+    int value = warmSearch.performSearch(connectFourGame->getState(), options, limits).value;
+    printRow("from position cache", warmSearch.getNodesVisited(), std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count(), value);
+    std::cout << "cache file " << std::filesystem::file_size(path) / 1024 << " KB" << std::endl;
+
+    std::filesystem::remove(path);
+  }
+
+  //Plays MctsSearch against MiniMaxSearch with the same time for every move and returns the mcts side's wins, draws and losses
+  //Each opening of a few pseudo random moves is played twice so that both engines play it with either colour
+  std::array<int, 3> playMctsMatch(const std::shared_ptr<SearchableGame>& game, MiniMaxSearch& minimax, const std::vector<MiniMaxSearch::Options>& options,
+    int openings, int openingMoves, std::chrono::milliseconds moveTime, std::uint64_t& playouts, int& mctsMoves)
+  {
+    MctsSearch mcts(game);
+    mcts.setRolloutPolicy(MctsSearch::RolloutPolicy::GAME);
+    MiniMaxSearch::Limits limits;
+    limits.time = moveTime;
+
+    std::array<int, 3> results = {0, 0, 0};
+    SearchableGame::MoveBuffer moves;
+    for (int opening = 0; opening < openings; ++opening)
+    {
+      for (bool mctsFirst : {true, false})
+      {
+        std::shared_ptr<State> state = game->cloneState(game->getState());
+        std::uint32_t seed = 12345 + opening;
+        for (int move = 0; move < openingMoves; ++move)
+        {
+          seed = seed * 1664525u + 1013904223u;
+          game->makeMove(state, moves[(seed >> 16) % game->generateMoves(state, moves)]);
+        }
+
+        Player firstPlayer = game->getPlayerFromState(state);
+        Player mctsPlayer = mctsFirst ? firstPlayer : (firstPlayer == Player::Player1) ? Player::Player2 : Player::Player1;
+        minimax.newGame();
+        mcts.setSeed(opening);
+        while (!game->terminalState(state))
+        {
+          bool mctsToMove = game->getPlayerFromState(state) == mctsPlayer;
+          ActionValue choice = mctsToMove ? mcts.performSearch(state, moveTime) : minimax.performSearch(state, options, limits);
+          if (mctsToMove)
+          {
+            playouts += mcts.getIterations();
+            mctsMoves++;
+          }
+
+          //both games' move ids are their action ids
+          std::size_t moveCount = game->generateMoves(state, moves);
+          int actionId = game->getActionId(choice.action);
+          for (std::size_t i = 0; i < moveCount; ++i)
+          {
+            if (game->getMoveId(moves[i]) == actionId)
+            {
+              game->makeMove(state, moves[i]);
+              break;
+            }
+          }
+        }
+
+        int utility = game->getUtility(state, mctsPlayer);
+        results[(utility > 0) ? 0 : (utility == 0) ? 1 : 2]++;
+      }
+    }
+    return results;
+  }
+
+  //Games between MctsSearch and the iterative deepening MiniMaxSearch for a range of move times, on tic-tac-toe, which MiniMaxSearch solves at any of them,
+  //and on connect four, where neither engine can see to the end
+  void compareMcts()
+  {
+    typedef MiniMaxSearch::Options Options;
+    const std::vector<Options> options = {Options::USE_PRUNING, Options::USE_TRANSPOSITION_TABLE, Options::USE_MOVE_ORDERING, Options::USE_PRINCIPAL_VARIATION_SEARCH, Options::USE_ASPIRATION_WINDOWS};
+
+    struct Match
+    {
+      std::string name;
+      std::shared_ptr<SearchableGame> game;
+      int openings;
+      int openingMoves;
+      std::vector<std::chrono::milliseconds> moveTimes;
+    };
+    const std::vector<Match> matches = {
+      {"tic-tac-toe", std::make_shared<TicTacToe>(), 3, 1, {std::chrono::milliseconds(1), std::chrono::milliseconds(10), std::chrono::milliseconds(50)}},
+      {"connect four", std::make_shared<ConnectFour>(), 2, 2, {std::chrono::milliseconds(10), std::chrono::milliseconds(40), std::chrono::milliseconds(160)}}
+    };
+
+    std::cout << std::endl << std::left << std::setw(22) << "mcts vs minimax" << std::setw(10) << "ms/move"
+              << std::right << std::setw(8) << "games" << std::setw(8) << "wins" << std::setw(8) << "draws" << std::setw(8) << "losses" << std::setw(16) << "playouts/move" << std::endl;
+
+    for (const Match& match : matches)
+    {
+      MiniMaxSearch minimax(match.game);
+      //connect four evaluations are on the scale of the line scores rather than single points
+      minimax.setAspirationWindow(16);
+      for (std::chrono::milliseconds moveTime : match.moveTimes)
+      {
+        std::uint64_t playouts = 0;
+        int mctsMoves = 0;
+        std::array<int, 3> results = playMctsMatch(match.game, minimax, options, match.openings, match.openingMoves, moveTime, playouts, mctsMoves);
+
+        std::cout << std::left << std::setw(22) << match.name << std::setw(10) << moveTime.count()
+                  << std::right << std::setw(8) << 2 * match.openings << std::setw(8) << results[0] << std::setw(8) << results[1] << std::setw(8) << results[2]
+                  << std::setw(16) << playouts / std::max(mctsMoves, 1) << std::endl;
+      }
+    }
+  }
+
+  //What the iterative deepening connect four search with every serial feature did at each depth - only available when built with MINIMAX_SEARCH_STATS
+  void printSearchStats()
+  {
+    typedef MiniMaxSearch::Options Options;
+    const std::vector<Options> options = {Options::USE_PRUNING, Options::USE_TRANSPOSITION_TABLE, Options::USE_MOVE_ORDERING,
+      Options::USE_PRINCIPAL_VARIATION_SEARCH, Options::USE_ASPIRATION_WINDOWS, Options::USE_SYMMETRY};
+
+    std::shared_ptr<ConnectFour> connectFourGame = std::make_shared<ConnectFour>();
+    MiniMaxSearch search(connectFourGame);
+    search.setAspirationWindow(16);
+    MiniMaxSearch::Limits limits;
+    limits.depth = 12;
+    search.performSearch(connectFourGame->getState(), options, limits);
+    const SearchStats& stats = search.getSearchStats();
+
+    std::cout << std::endl << std::left << std::setw(10) << "iteration" << std::right << std::setw(12) << "nodes" << std::setw(12) << "seconds" << std::endl;
+    for (const SearchStats::Iteration& iteration : stats.iterations)
+      std::cout << std::left << std::setw(10) << iteration.depth << std::right << std::setw(12) << iteration.nodes
+                << std::setw(12) << std::fixed << std::setprecision(4) << iteration.seconds << std::endl;
+
+    std::cout << "terminal leaves " << stats.terminalLeaves << ", evaluated leaves " << stats.evaluatedLeaves << std::endl
+              << "tt probes " << stats.transpositionProbes << ", hits " << stats.transpositionHits
+              << ", stores " << stats.transpositionStores << ", collisions " << stats.transpositionCollisions << std::endl
+              << "beta cutoffs " << stats.betaCutoffs << ", first move cutoff rate " << std::setprecision(3) << stats.getFirstMoveCutoffRate()
+              << ", effective branching factor " << stats.getEffectiveBranchingFactor() << std::endl;
+  }
+
+  //Traces a connect four search in both formats, for chrome://tracing or Perfetto and for flamegraph.pl
+  void writeSearchTraces()
+  {
+    typedef MiniMaxSearch::Options Options;
+    const std::vector<Options> options = {Options::USE_PRUNING, Options::USE_TRANSPOSITION_TABLE, Options::USE_MOVE_ORDERING, Options::USE_PRINCIPAL_VARIATION_SEARCH};
+
+    std::shared_ptr<ConnectFour> connectFourGame = std::make_shared<ConnectFour>();
+    MiniMaxSearch search(connectFourGame);
+    MiniMaxSearch::Limits limits;
+    limits.depth = 10;
+    auto start = std::chrono::steady_clock::now();
+    search.performSearch(connectFourGame->getState(), options, limits);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const std::vector<std::pair<SearchTrace::Format, std::string>> files = {{SearchTrace::Format::CHROME, "search_trace.json"}, {SearchTrace::Format::COLLAPSED, "search_trace.folded"}};
+    for (const auto& [format, path] : files)
+    {
+      std::ofstream file(path);
+      search.writeSearchTrace(file, format);
+    }
+    std::cout << std::endl << "traced " << search.getNodesVisited() << " nodes in " << std::fixed << std::setprecision(4) << seconds << "s, written to search_trace.json and search_trace.folded" << std::endl;
+  }
+
+  //Fixed depth searches of connect four from the empty board as search features are added, then the parallel searches on top of all of them
+  //unlike tic-tac-toe the tree cannot be searched to the end so these show how far each feature lets the search see in the same time
+  void compareConnectFour(int repetitions)
+  {
+    typedef MiniMaxSearch::Options Options;
+    const std::vector<std::pair<std::string, std::vector<Options>>> searches = {
+      {"pruning", {Options::USE_PRUNING}},
+      {"+tt", {Options::USE_PRUNING, Options::USE_TRANSPOSITION_TABLE}},
+      {"+ordering", {Options::USE_PRUNING, Options::USE_TRANSPOSITION_TABLE, Options::USE_MOVE_ORDERING}},
+      {"+pvs", {Options::USE_PRUNING, Options::USE_TRANSPOSITION_TABLE, Options::USE_MOVE_ORDERING, Options::USE_PRINCIPAL_VARIATION_SEARCH}},
+      {"+sym", {Options::USE_PRUNING, Options::USE_TRANSPOSITION_TABLE, Options::USE_MOVE_ORDERING, Options::USE_PRINCIPAL_VARIATION_SEARCH, Options::USE_SYMMETRY}},
+      {"+young brothers", {Options::USE_PRUNING, Options::USE_TRANSPOSITION_TABLE, Options::USE_MOVE_ORDERING, Options::USE_PRINCIPAL_VARIATION_SEARCH, Options::USE_SYMMETRY, Options::USE_YOUNG_BROTHERS_WAIT}}
+    };
+    const int parallelThreadCount = 4;
+
+    std::shared_ptr<ConnectFour> connectFourGame = std::make_shared<ConnectFour>();
+    std::shared_ptr<SearchableGame> game = connectFourGame;
+    MiniMaxSearch search(game);
+
+    std::cout << std::endl << std::left << std::setw(22) << "connect four" << std::setw(10) << "threads" << std::setw(8) << "depth"
+              << std::right << std::setw(12) << "nodes" << std::setw(12) << "seconds" << std::setw(16) << "nodes/sec" << std::setw(8) << "value" << std::endl;
+
+    for (int depth : {8, 12})
+    {
+      for (const auto& [name, options] : searches)
+      {
+        //young brothers wait only differs from the serial search with more than one thread, the rest run as lazy smp as well
+        std::vector<int> threadCounts = {parallelThreadCount};
+        if (options.back() != Options::USE_YOUNG_BROTHERS_WAIT)
+          threadCounts.insert(threadCounts.begin(), 1);
+        for (int threadCount : threadCounts)
+        {
+          MiniMaxSearch::Limits limits;
+          limits.depth = depth;
+
+          std::uint64_t nodes = 0;
+          int value = 0;
+          auto start = std::chrono::high_resolution_clock::now();
+          for (int i = 0; i < repetitions; ++i)
+          {
+            search.newGame();
+            value = search.performSearch(connectFourGame->getState(), options, limits, threadCount).value;
+            nodes += search.getNodesVisited();
+          }
+          double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+          std::cout << std::left << std::setw(22) << name << std::setw(10) << threadCount << std::setw(8) << depth
+                    << std::right << std::setw(12) << nodes / repetitions
+                    << std::setw(12) << std::fixed << std::setprecision(4) << seconds / repetitions
+                    << std::setw(16) << std::setprecision(0) << nodes / seconds << std::setw(8) << value << std::endl;
+        }
+      }
+    }
+  }
+}
+
+namespace
+{
+  //Destroying a search while it ponders has to stop and join the ponder search before the members it reads are destroyed
+  bool checkPonderDestroy()
+  {
+    typedef MiniMaxSearch::Options Options;
+    std::shared_ptr<ConnectFour> connectFourGame = std::make_shared<ConnectFour>();
+    MiniMaxSearch::Limits limits;
+    limits.time = std::chrono::seconds(60);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int threadCount : {1, 2})
+    {
+      MiniMaxSearch search(connectFourGame);
+      search.startPondering(connectFourGame->getState(), {Options::USE_PRUNING, Options::USE_TRANSPOSITION_TABLE, Options::USE_MOVE_ORDERING}, limits, threadCount);
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    //the ponder searches have no time limit of their own so only being stopped ends them
+    return std::chrono::steady_clock::now() - start < std::chrono::seconds(10);
+  }
+
+  int runCheck(const std::string& name)
+  {
+    const std::vector<std::pair<std::string, bool (*)()>> checks = {
+      {"ponder-destroy", checkPonderDestroy},
+      {"oracle", compareOracle}
+    };
+
+    for (const auto& [checkName, check] : checks)
+    {
+      if (checkName != name)
+        continue;
+      bool passed = check();
+      std::cout << name << (passed ? " passed" : " FAILED") << std::endl;
+      return passed ? 0 : 1;
+    }
+
+    std::cerr << "Unknown check " << name << std::endl;
+    return 1;
+  }
+}
+
+//With no arguments prints the comparison tables, otherwise runs the benchmark corpus:
+//minimax_bench --format csv|json [--repetitions n] [--output file]
+//or one of the regression checks ctest runs, failing with a non-zero exit status:
+//minimax_bench --check <name>
+int main(int argc, char* argv[])
+{
+  if (argc == 3 && std::string(argv[1]) == "--check")
+    return runCheck(argv[2]);
+
+  if (argc > 1)
+  {
+    BenchmarkCorpus::Format format = BenchmarkCorpus::Format::CSV;
+    int corpusRepetitions = 5;
+    std::string outputPath;
+    for (int i = 1; i < argc; ++i)
+    {
+      std::string argument = argv[i];
+      bool hasValue = i + 1 < argc;
+      if (argument == "--format" && hasValue && std::string(argv[i + 1]) == "csv")
+        format = BenchmarkCorpus::Format::CSV;
+      else if (argument == "--format" && hasValue && std::string(argv[i + 1]) == "json")
+        format = BenchmarkCorpus::Format::JSON;
+      else if (argument == "--repetitions" && hasValue)
+        corpusRepetitions = std::atoi(argv[i + 1]);
+      else if (argument == "--output" && hasValue)
+        outputPath = argv[i + 1];
+      else
+      {
+        std::cerr << "Usage: " << argv[0] << " [--format csv|json] [--repetitions n] [--output file]" << std::endl
+                  << "       " << argv[0] << " --check <name>" << std::endl;
+        return 1;
+      }
+      ++i;
+    }
+
+    BenchmarkCorpus corpus(format, corpusRepetitions);
+    if (outputPath.empty())
+    {
+      corpus.run(std::cout);
+      return 0;
+    }
+
+    std::ofstream output(outputPath);
+    if (!output)
+    {
+      std::cerr << "Could not open " << outputPath << std::endl;
+      return 1;
+    }
+    corpus.run(output);
+    return 0;
+  }
+
+  const int repetitions = 5;
+
+  std::shared_ptr<TicTacToe> ticTacGame = std::make_shared<TicTacToe>();
+  std::shared_ptr<SearchableGame> searchableGame = ticTacGame;
+  StaticTicTacToe staticGame;
+
+  std::shared_ptr<SearchableGame> successorStatesGame = std::make_shared<SuccessorStatesTicTacToe>();
+
+  MiniMaxSearch virtualSearch(searchableGame);
+  MiniMaxSearch successorStatesSearch(successorStatesGame);
+  StaticMiniMaxSearch<StaticTicTacToe> staticSearch(staticGame);
+  StaticMiniMaxSearch<SearchableGameAdapter> adaptedSearch{SearchableGameAdapter(searchableGame)};
+
+  std::cout << std::left << std::setw(30) << "engine" << std::setw(12) << "mode"
+            << std::right << std::setw(12) << "nodes" << std::setw(12) << "seconds"
+            << std::setw(16) << "nodes/sec" << std::setw(8) << "value" << std::endl;
+
+  for (bool pruning : {false, true})
+  {
+    std::string mode = pruning ? "pruning" : "minimax";
+
+    std::vector<MiniMaxSearch::Options> virtualOptions;
+    std::vector<StaticMiniMaxSearch<StaticTicTacToe>::Options> staticOptions;
+    std::vector<StaticMiniMaxSearch<SearchableGameAdapter>::Options> adaptedOptions;
+    if (pruning)
+    {
+      virtualOptions.push_back(MiniMaxSearch::Options::USE_PRUNING);
+      staticOptions.push_back(StaticMiniMaxSearch<StaticTicTacToe>::Options::USE_PRUNING);
+      adaptedOptions.push_back(StaticMiniMaxSearch<SearchableGameAdapter>::Options::USE_PRUNING);
+    }
+
+    SearchRunner<MiniMaxSearch, std::shared_ptr<State>, MiniMaxSearch::Options> virtualRunner{virtualSearch, ticTacGame->getState(), virtualOptions};
+    printResult("MiniMaxSearch", mode, timeSearch(virtualRunner, repetitions));
+
+    SearchRunner<MiniMaxSearch, std::shared_ptr<State>, MiniMaxSearch::Options> successorStatesRunner{successorStatesSearch, ticTacGame->getState(), virtualOptions};
+    printResult("MiniMaxSearch successors", mode, timeSearch(successorStatesRunner, repetitions));
+
+    SearchRunner<StaticMiniMaxSearch<SearchableGameAdapter>, std::shared_ptr<State>, StaticMiniMaxSearch<SearchableGameAdapter>::Options> adaptedRunner{adaptedSearch, ticTacGame->getState(), adaptedOptions};
+    printResult("StaticMiniMaxSearch<Adapter>", mode, timeSearch(adaptedRunner, repetitions));
+
+    SearchRunner<StaticMiniMaxSearch<StaticTicTacToe>, StaticTicTacToe::StateType, StaticMiniMaxSearch<StaticTicTacToe>::Options> staticRunner{staticSearch, staticGame.getState(), staticOptions};
+    printResult("StaticMiniMaxSearch", mode, timeSearch(staticRunner, repetitions));
+
+    virtualOptions.push_back(MiniMaxSearch::Options::USE_TRANSPOSITION_TABLE);
+    SearchRunner<MiniMaxSearch, std::shared_ptr<State>, MiniMaxSearch::Options> transpositionRunner{virtualSearch, ticTacGame->getState(), virtualOptions};
+    printResult("MiniMaxSearch", mode + "+tt", timeSearch(transpositionRunner, repetitions));
+
+    virtualOptions.push_back(MiniMaxSearch::Options::USE_SYMMETRY);
+    SearchRunner<MiniMaxSearch, std::shared_ptr<State>, MiniMaxSearch::Options> symmetryRunner{virtualSearch, ticTacGame->getState(), virtualOptions};
+    printResult("MiniMaxSearch", mode + "+tt+sym", timeSearch(symmetryRunner, repetitions));
+  }
+
+  compareSearchFeatures(searchableGame);
+  compareSuccessorGeneration();
+  compareSearchArena(repetitions);
+  compareThreadCounts(searchableGame, repetitions);
+  compareConnectFour(repetitions);
+  compareBatchSearch(repetitions);
+  compareMoveTimes();
+  compareBatchEvaluation(repetitions);
+  bool oracleAgrees = compareOracle();
+  compareWarmStart();
+  compareMcts();
+  if constexpr (SEARCH_STATS_ENABLED)
+    printSearchStats();
+  if constexpr (SEARCH_TRACE_ENABLED)
+    writeSearchTraces();
+
+  if (!oracleAgrees)
+  {
+    std::cerr << "The search disagreed with the tic-tac-toe oracle" << std::endl;
+    return 1;
+  }
+  return 0;
+}
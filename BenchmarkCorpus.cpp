@@ -0,0 +1,216 @@
+#include "BenchmarkCorpus.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "TicTacToe.hpp"
+#include "ConnectFour.hpp"
+
+namespace
+{
+  typedef MiniMaxSearch::Options Options;
+
+  //Young brothers wait is left out as it only differs from the serial search with more than one thread
+  const std::vector<std::pair<Options, std::string>> OPTION_NAMES = {
+    {Options::USE_TRANSPOSITION_TABLE, "tt"},
+    {Options::USE_PRUNING, "pruning"},
+    {Options::USE_MOVE_ORDERING, "ordering"},
+    {Options::USE_PRINCIPAL_VARIATION_SEARCH, "pvs"},
+    {Options::USE_ASPIRATION_WINDOWS, "aspiration"},
+    {Options::USE_SEARCH_ARENA, "arena"},
+    {Options::USE_SYMMETRY, "symmetry"},
+    {Options::USE_BATCH_EVALUATION, "batch"},
+    {Options::USE_MTDF, "mtdf"}
+  };
+
+  std::shared_ptr<State> getConnectFourState(const std::vector<int>& columns)
+  {
+    ConnectFour connectFourGame;
+    for (int column : columns)
+      connectFourGame.makeMove(column);
+    return connectFourGame.getState();
+  }
+}
+
+BenchmarkCorpus::BenchmarkCorpus(Format format, int repetitions)
+  : format(format), repetitions(std::max(repetitions, 1))
+{
+  std::shared_ptr<SearchableGame> ticTacGame = std::make_shared<TicTacToe>();
+  std::shared_ptr<SearchableGame> connectFourGame = std::make_shared<ConnectFour>();
+
+  positions = {
+    {"tictactoe", "empty", ticTacGame, std::make_shared<TicTacToeState>(std::array<char, 9>{'-', '-', '-', '-', '-', '-', '-', '-', '-'}), {4, -1}, 1},
+    {"tictactoe", "corner", ticTacGame, std::make_shared<TicTacToeState>(std::array<char, 9>{'X', '-', '-', '-', '-', '-', '-', '-', '-'}), {4, -1}, 1},
+    {"tictactoe", "midgame", ticTacGame, std::make_shared<TicTacToeState>(std::array<char, 9>{'X', '-', '-', '-', 'O', '-', '-', '-', 'X'}), {-1}, 1},
+    {"connectfour", "empty", connectFourGame, getConnectFourState({}), {5, 8}, 16},
+    {"connectfour", "opening", connectFourGame, getConnectFourState({3, 3, 2}), {5, 8}, 16},
+    {"connectfour", "threat", connectFourGame, getConnectFourState({3, 3, 2, 6, 1}), {5, 8}, 16}
+  };
+}
+
+std::vector<std::vector<MiniMaxSearch::Options>> BenchmarkCorpus::getOptionCombinations()
+{
+  std::vector<std::vector<Options>> combinations;
+  for (unsigned int mask = 0; mask < (1u << OPTION_NAMES.size()); ++mask)
+  {
+    std::vector<Options> options;
+    for (std::size_t i = 0; i < OPTION_NAMES.size(); ++i)
+    {
+      if (mask & (1u << i))
+        options.push_back(OPTION_NAMES[i].first);
+    }
+
+    //combinations which would search exactly as one already in the list are skipped
+    auto hasOption = [&options](Options option) { return std::find(options.begin(), options.end(), option) != options.end(); };
+    bool needsPruning = hasOption(Options::USE_MOVE_ORDERING) || hasOption(Options::USE_PRINCIPAL_VARIATION_SEARCH) || hasOption(Options::USE_ASPIRATION_WINDOWS);
+    if (needsPruning && !hasOption(Options::USE_PRUNING))
+      continue;
+    if (hasOption(Options::USE_SYMMETRY) && !hasOption(Options::USE_TRANSPOSITION_TABLE))
+      continue;
+    //MTD(f) is only compared with the pruning searches it is meant to replace, which have the transposition table it relies on
+    if (hasOption(Options::USE_MTDF) && (!hasOption(Options::USE_PRUNING) || !hasOption(Options::USE_TRANSPOSITION_TABLE) || hasOption(Options::USE_ASPIRATION_WINDOWS)))
+      continue;
+
+    combinations.push_back(options);
+  }
+
+  return combinations;
+}
+
+std::string BenchmarkCorpus::getOptionsName(const std::vector<MiniMaxSearch::Options>& options)
+{
+  std::string name;
+  for (const auto& [option, optionName] : OPTION_NAMES)
+  {
+    if (std::find(options.begin(), options.end(), option) == options.end())
+      continue;
+    if (!name.empty())
+      name += "+";
+    name += optionName;
+  }
+
+  return name.empty() ? "none" : name;
+}
+
+void BenchmarkCorpus::run(std::ostream& out) const
+{
+  if (format == Format::CSV)
+    out << "game,position,options,depth,nodes,value,median_seconds,min_seconds,nodes_per_second,tt_probes,tt_hits,tt_hit_rate,peak_rss_kb" << std::endl;
+  else
+    out << "{" << std::endl << "  \"repetitions\": " << repetitions << "," << std::endl << "  \"results\": [";
+
+  bool first = true;
+  for (const Position& position : positions)
+  {
+    for (int depth : position.depths)
+    {
+      for (const std::vector<Options>& options : getOptionCombinations())
+      {
+        Result result;
+        if (!runSearch(position, options, depth, result))
+        {
+          std::cerr << "Search of " << position.game << " " << position.name << " with " << getOptionsName(options) << " failed" << std::endl;
+          continue;
+        }
+
+        double nodesPerSecond = (result.medianSeconds > 0.0) ? result.nodes / result.medianSeconds : 0.0;
+        double hitRate = (result.transpositionProbes > 0) ? static_cast<double>(result.transpositionHits) / result.transpositionProbes : 0.0;
+
+        if (format == Format::CSV)
+        {
+          out << position.game << "," << position.name << "," << getOptionsName(options) << "," << depth << ","
+              << result.nodes << "," << result.value << ","
+              << std::fixed << std::setprecision(6) << result.medianSeconds << "," << result.minSeconds << ","
+              << std::setprecision(0) << nodesPerSecond << ","
+              << result.transpositionProbes << "," << result.transpositionHits << ","
+              << std::setprecision(4) << hitRate << "," << result.peakRssKB << std::endl;
+        }
+        else
+        {
+          out << (first ? "" : ",") << std::endl
+              << "    {\"game\": \"" << position.game << "\", \"position\": \"" << position.name << "\", \"options\": \"" << getOptionsName(options) << "\", \"depth\": " << depth
+              << ", \"nodes\": " << result.nodes << ", \"value\": " << result.value
+              << std::fixed << std::setprecision(6) << ", \"median_seconds\": " << result.medianSeconds << ", \"min_seconds\": " << result.minSeconds
+              << std::setprecision(0) << ", \"nodes_per_second\": " << nodesPerSecond
+              << ", \"tt_probes\": " << result.transpositionProbes << ", \"tt_hits\": " << result.transpositionHits
+              << std::setprecision(4) << ", \"tt_hit_rate\": " << hitRate << ", \"peak_rss_kb\": " << result.peakRssKB << "}";
+        }
+        first = false;
+      }
+    }
+  }
+
+  if (format == Format::JSON)
+    out << std::endl << "  ]" << std::endl << "}" << std::endl;
+}
+
+bool BenchmarkCorpus::runSearch(const Position& position, const std::vector<MiniMaxSearch::Options>& options, int depth, Result& result) const
+{
+  //each search runs in a child process so that its peak RSS is not hidden by whatever ran before it, the result comes back through a pipe
+  int fds[2];
+  if (pipe(fds) != 0)
+    return false;
+
+  pid_t child = fork();
+  if (child < 0)
+  {
+    close(fds[0]);
+    close(fds[1]);
+    return false;
+  }
+
+  if (child == 0)
+  {
+    close(fds[0]);
+    Result childResult = search(position, options, depth);
+    bool written = write(fds[1], &childResult, sizeof(childResult)) == sizeof(childResult);
+    close(fds[1]);
+    _exit(written ? 0 : 1);
+  }
+
+  close(fds[1]);
+  bool received = read(fds[0], &result, sizeof(result)) == sizeof(result);
+  close(fds[0]);
+
+  int status = 0;
+  rusage usage = {};
+  wait4(child, &status, 0, &usage);
+  result.peakRssKB = usage.ru_maxrss;
+  return received && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+BenchmarkCorpus::Result BenchmarkCorpus::search(const Position& position, const std::vector<MiniMaxSearch::Options>& options, int depth) const
+{
+  MiniMaxSearch search(position.searchableGame);
+  search.setAspirationWindow(position.aspirationWindow);
+  MiniMaxSearch::Limits limits;
+  limits.depth = depth;
+
+  //the first search warms the caches and the transposition table's pages and is not timed
+  search.performSearch(position.state, options, limits);
+
+  Result result = {0, 0, 0, 0.0, 0.0, 0, 0};
+  std::vector<double> seconds;
+  for (int i = 0; i < repetitions; ++i)
+  {
+    //every repetition starts from an empty transposition table so that the searches before it do not help it along
+    search.newGame();
+    auto start = std::chrono::high_resolution_clock::now();
+    result.value = search.performSearch(position.state, options, limits).value;
+    seconds.push_back(std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count());
+  }
+
+  result.nodes = search.getNodesVisited();
+  result.transpositionProbes = search.getTranspositionTableProbes();
+  result.transpositionHits = search.getTranspositionTableHits();
+  std::sort(seconds.begin(), seconds.end());
+  result.medianSeconds = seconds[seconds.size() / 2];
+  result.minSeconds = seconds.front();
+  return result;
+}
@@ -0,0 +1,58 @@
+#ifndef BENCHMARK_CORPUS_H_
+#define BENCHMARK_CORPUS_H_
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "MiniMax.hpp"
+
+//Runs a fixed corpus of tic-tac-toe and connect four positions through every combination of search options at a few depths
+//and writes one record per run as CSV or JSON, so that the results of two commits can be compared line by line
+//Every search is single threaded so node counts are exactly repeatable and only the times vary from run to run
+class BenchmarkCorpus
+{
+public:
+  enum class Format
+  {
+    CSV,
+    JSON
+  };
+
+  BenchmarkCorpus(Format format, int repetitions);
+  void run(std::ostream& out) const;
+
+private:
+  struct Position
+  {
+    std::string game;
+    std::string name;
+    std::shared_ptr<SearchableGame> searchableGame;
+    std::shared_ptr<State> state;
+    //-1 searches to the end of the game
+    std::vector<int> depths;
+    int aspirationWindow;
+  };
+
+  struct Result
+  {
+    std::uint64_t nodes;
+    std::uint64_t transpositionProbes;
+    std::uint64_t transpositionHits;
+    double medianSeconds;
+    double minSeconds;
+    int value;
+    long peakRssKB;
+  };
+
+  const Format format;
+  const int repetitions;
+  std::vector<Position> positions;
+
+  static std::vector<std::vector<MiniMaxSearch::Options>> getOptionCombinations();
+  static std::string getOptionsName(const std::vector<MiniMaxSearch::Options>& options);
+  bool runSearch(const Position& position, const std::vector<MiniMaxSearch::Options>& options, int depth, Result& result) const;
+  Result search(const Position& position, const std::vector<MiniMaxSearch::Options>& options, int depth) const;
+};
+
+#endif
@@ -0,0 +1,262 @@
+#include "ConnectFour.hpp"
+
+#include <iostream>
+#include <bit>
+#include <cstdlib>
+
+namespace
+{
+  constexpr int WINDOW_COUNT = 69;
+
+  //Every line of four cells on the board
+  constexpr std::array<std::uint64_t, WINDOW_COUNT> makeWindows()
+  {
+    std::array<std::uint64_t, WINDOW_COUNT> windows = {};
+    int count = 0;
+    const int steps[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+    for (const auto& step : steps)
+    {
+      for (int column = 0; column < ConnectFourBoard::COLUMNS; ++column)
+      {
+        for (int row = 0; row < ConnectFourBoard::ROWS; ++row)
+        {
+          int endColumn = column + 3 * step[0];
+          int endRow = row + 3 * step[1];
+          if (endColumn >= ConnectFourBoard::COLUMNS || endRow < 0 || endRow >= ConnectFourBoard::ROWS)
+            continue;
+
+          std::uint64_t window = 0;
+          for (int i = 0; i < 4; ++i)
+            window |= std::uint64_t(1) << ConnectFourBoard::getBit(column + i * step[0], row + i * step[1]);
+          windows[count++] = window;
+        }
+      }
+    }
+    return windows;
+  }
+
+  constexpr std::array<std::uint64_t, WINDOW_COUNT> WINDOWS = makeWindows();
+  //Score of a line by how many of its cells one player holds when the other holds none of them
+  constexpr std::array<int, 5> WINDOW_SCORES = {0, 1, 8, 64, 512};
+  constexpr int CENTRE_COLUMN_SCORE = 3;
+
+  int scoreWindows(std::uint64_t own, std::uint64_t opponent)
+  {
+    int score = 0;
+    for (std::uint64_t window : WINDOWS)
+    {
+      if ((window & opponent) == 0)
+        score += WINDOW_SCORES[std::popcount(window & own)];
+    }
+
+    std::uint64_t centreColumn = ((std::uint64_t(1) << ConnectFourBoard::ROWS) - 1) << ConnectFourBoard::getBit(ConnectFourBoard::COLUMNS / 2, 0);
+    return score + CENTRE_COLUMN_SCORE * std::popcount(own & centreColumn);
+  }
+}
+
+bool ConnectFourState::operator==(const std::shared_ptr<State>& rhs) const
+{
+  return board == static_cast<const ConnectFourState&>(*rhs).board;
+}
+
+std::size_t ConnectFourState::getHash() const
+{
+  return board.hash;
+}
+
+int ConnectFourState::mapActionId(int actionId, int symmetry, bool toCanonical) const
+{
+  //action ids are columns and the only symmetry is a reflection, which is its own inverse
+  return (symmetry == 1) ? ConnectFourBoard::COLUMNS - 1 - actionId : actionId;
+}
+
+ConnectFour::ConnectFour()
+{
+  currentPlayer = Player::Player1;
+}
+
+void ConnectFour::makeMove(int column)
+{
+  if (!board.canPlay(column))
+    throw ConnectFourInvalidMoveException();
+
+  board.place(column, currentPlayer);
+  currentPlayer = (currentPlayer == Player::Player1) ? Player::Player2 : Player::Player1;
+}
+
+std::vector<std::pair<std::shared_ptr<State>, std::shared_ptr<Action>>> ConnectFour::successorStates(const std::shared_ptr<State>& state) const
+{
+  const ConnectFourBoard& board = static_cast<const ConnectFourState&>(*state).board;
+  Player player = board.getPlayerToMove();
+
+  std::vector<std::pair<std::shared_ptr<State>, std::shared_ptr<Action>>> stateActions;
+  for (int column : ConnectFourBoard::COLUMN_ORDER)
+  {
+    if (!board.canPlay(column))
+      continue;
+
+    ConnectFourBoard possibleBoard = board;
+    possibleBoard.place(column, player);
+    stateActions.emplace_back(makeSearchShared<ConnectFourState>(possibleBoard), makeSearchShared<ConnectFourAction>(column));
+  }
+
+  return stateActions;
+}
+
+bool ConnectFour::nextSuccessor(const std::shared_ptr<State>& state, SuccessorCursor& cursor, std::pair<std::shared_ptr<State>, std::shared_ptr<Action>>& successor) const
+{
+  const ConnectFourBoard& board = static_cast<const ConnectFourState&>(*state).board;
+  while (cursor.position < ConnectFourBoard::COLUMN_ORDER.size())
+  {
+    int column = ConnectFourBoard::COLUMN_ORDER[cursor.position++];
+    if (!board.canPlay(column))
+      continue;
+
+    ConnectFourBoard possibleBoard = board;
+    possibleBoard.place(column, board.getPlayerToMove());
+    successor = {makeSearchShared<ConnectFourState>(possibleBoard), makeSearchShared<ConnectFourAction>(column)};
+    return true;
+  }
+
+  return false;
+}
+
+bool ConnectFour::terminalState(const std::shared_ptr<State>& state) const
+{
+  return static_cast<const ConnectFourState&>(*state).board.checkEndOfGame();
+}
+
+int ConnectFour::getUtility(const std::shared_ptr<State>& state, const Player& player) const
+{
+  const ConnectFourBoard& board = static_cast<const ConnectFourState&>(*state).board;
+  Player oppositePlayer = (player == Player::Player1) ? Player::Player2 : Player::Player1;
+  int winValue = WIN_VALUE + ConnectFourBoard::CELLS - board.moveCount;
+  if (board.checkWinner(player))
+    return winValue;
+  if (board.checkWinner(oppositePlayer))
+    return -winValue;
+
+  return 0;
+}
+
+int ConnectFour::getEvaluationValue(const std::shared_ptr<State>& state, const Player& player) const
+{
+  const ConnectFourBoard& board = static_cast<const ConnectFourState&>(*state).board;
+  Player oppositePlayer = (player == Player::Player1) ? Player::Player2 : Player::Player1;
+  std::uint64_t own = board.getMask(player);
+  std::uint64_t opponent = board.getMask(oppositePlayer);
+  return scoreWindows(own, opponent) - scoreWindows(opponent, own);
+}
+
+Player ConnectFour::getPlayerFromState(const std::shared_ptr<State>& state) const
+{
+  return static_cast<const ConnectFourState&>(*state).board.getPlayerToMove();
+}
+
+int ConnectFour::getActionId(const std::shared_ptr<Action>& action) const
+{
+  return static_cast<const ConnectFourAction&>(*action).column;
+}
+
+int ConnectFour::getMoveOrderingScore(const std::shared_ptr<State>& state, const std::shared_ptr<Action>& action) const
+{
+  return getMoveScore(state, static_cast<const ConnectFourAction&>(*action).column);
+}
+
+std::shared_ptr<State> ConnectFour::cloneState(const std::shared_ptr<State>& state) const
+{
+  return makeSearchShared<ConnectFourState>(static_cast<const ConnectFourState&>(*state).board);
+}
+
+std::size_t ConnectFour::generateMoves(const std::shared_ptr<State>& state, MoveBuffer& moves) const
+{
+  const ConnectFourBoard& board = static_cast<const ConnectFourState&>(*state).board;
+  std::size_t moveCount = 0;
+  for (int column : ConnectFourBoard::COLUMN_ORDER)
+  {
+    if (board.canPlay(column))
+      moves[moveCount++] = column;
+  }
+  return moveCount;
+}
+
+void ConnectFour::makeMove(const std::shared_ptr<State>& state, Move move) const
+{
+  ConnectFourBoard& board = static_cast<ConnectFourState&>(*state).board;
+  board.place(move, board.getPlayerToMove());
+}
+
+void ConnectFour::unmakeMove(const std::shared_ptr<State>& state, Move move) const
+{
+  //the counter being taken off belongs to whoever is not to move now
+  ConnectFourBoard& board = static_cast<ConnectFourState&>(*state).board;
+  board.remove(move, (board.getPlayerToMove() == Player::Player1) ? Player::Player2 : Player::Player1);
+}
+
+std::shared_ptr<Action> ConnectFour::getMoveAction(const std::shared_ptr<State>& state, Move move) const
+{
+  return std::make_shared<ConnectFourAction>(move);
+}
+
+int ConnectFour::getMoveScore(const std::shared_ptr<State>& state, Move move) const
+{
+  //columns nearer the centre take part in more lines
+  int distanceFromCentre = static_cast<int>(move) - ConnectFourBoard::COLUMNS / 2;
+  return ConnectFourBoard::COLUMNS / 2 - std::abs(distanceFromCentre);
+}
+
+std::size_t ConnectFour::chooseRolloutMove(const std::shared_ptr<State>& state, const MoveBuffer& moves, std::size_t moveCount, std::uint64_t random) const
+{
+  const ConnectFourBoard& board = static_cast<const ConnectFourState&>(*state).board;
+  Player player = board.getPlayerToMove();
+  for (Player mover : {player, (player == Player::Player1) ? Player::Player2 : Player::Player1})
+  {
+    for (std::size_t i = 0; i < moveCount; ++i)
+    {
+      ConnectFourBoard possibleBoard = board;
+      possibleBoard.place(moves[i], mover);
+      if (possibleBoard.checkWinner(mover))
+        return i;
+    }
+  }
+  return random % moveCount;
+}
+
+std::shared_ptr<State> ConnectFour::getState() const
+{
+  std::shared_ptr<State> currentState = std::make_shared<ConnectFourState>(board);
+  return currentState;
+}
+
+void ConnectFour::printState(const std::shared_ptr<State>& state) const
+{
+  const ConnectFourBoard& board = static_cast<const ConnectFourState&>(*state).board;
+  for (int row = ConnectFourBoard::ROWS - 1; row >= 0; --row)
+  {
+    for (int column = 0; column < ConnectFourBoard::COLUMNS; ++column)
+      std::cout << board.at(column, row);
+    std::cout << std::endl;
+  }
+}
+
+void ConnectFour::printAction(const std::shared_ptr<Action>& action) const
+{
+  std::shared_ptr<ConnectFourAction> connectFourAction = std::dynamic_pointer_cast<ConnectFourAction>(action);
+  std::cout << connectFourAction->column << std::endl;
+}
+
+std::ostream& operator<< (std::ostream &out, const ConnectFour& connectFourGame)
+{
+  out << std::endl;
+  for (int row = ConnectFourBoard::ROWS - 1; row >= 0; --row)
+  {
+    for (int column = 0; column < ConnectFourBoard::COLUMNS; ++column)
+      out << connectFourGame.board.at(column, row) << " ";
+    out << std::endl;
+  }
+
+  for (int column = 0; column < ConnectFourBoard::COLUMNS; ++column)
+    out << column << " ";
+
+  return out << std::endl;
+}
@@ -0,0 +1,85 @@
+#ifndef CONNECT_FOUR_H_
+#define CONNECT_FOUR_H_
+
+#include "MiniMax.hpp"
+#include "ConnectFourBoard.hpp"
+
+struct ConnectFourState : public State
+{
+  ConnectFourBoard board;
+
+  ConnectFourState(const ConnectFourBoard& board) : board(board) {}
+
+  bool operator==(const std::shared_ptr<State>& rhs) const override;
+  std::size_t getHash() const override;
+  std::size_t getCanonicalHash(int& symmetry) const override { return board.getCanonicalHash(symmetry); }
+  int mapActionId(int actionId, int symmetry, bool toCanonical) const override;
+};
+
+struct ConnectFourAction : public Action
+{
+  const int column;
+
+  ConnectFourAction(const int column) : column(column) {}
+};
+
+class ConnectFour : public SearchableGame
+{
+public:
+
+  class ConnectFourInvalidMoveException : public std::exception
+  {
+  public:
+    virtual const char* what() const throw() override { return "Cannot move there - must move to a column on the board that is not full"; }
+  };
+
+  //Wins are worth more than any evaluation, and more the sooner they come
+  static constexpr int WIN_VALUE = 1000000;
+
+  ConnectFour();
+
+  void makeMove(int column);
+  bool checkEndOfGame() const { return board.checkEndOfGame(); }
+  bool checkWinner(Player player) const { return board.checkWinner(player); };
+
+  //To implement SearchableGame
+  std::vector<std::pair<std::shared_ptr<State>, std::shared_ptr<Action>>> successorStates(const std::shared_ptr<State>& state) const override;
+  bool terminalState(const std::shared_ptr<State>& state) const override;
+  int getUtility(const std::shared_ptr<State>& state, const Player& player) const override;
+  Player getPlayerFromState(const std::shared_ptr<State>& state) const override;
+  std::shared_ptr<State> getState() const override;
+  //position holds how many columns of COLUMN_ORDER have been tried
+  bool nextSuccessor(const std::shared_ptr<State>& state, SuccessorCursor& cursor, std::pair<std::shared_ptr<State>, std::shared_ptr<Action>>& successor) const override;
+
+  //Counts the lines of four each player could still complete, weighted by how many counters they already have in them
+  int getEvaluationValue(const std::shared_ptr<State>& state, const Player& player) const override;
+  int getActionId(const std::shared_ptr<Action>& action) const override;
+  int getActionIdCount() const override { return ConnectFourBoard::COLUMNS; }
+  std::uint64_t getHashFingerprint() const override { return ConnectFourBoard::ZOBRIST_KEYS.getFingerprint(); }
+  int getMoveOrderingScore(const std::shared_ptr<State>& state, const std::shared_ptr<Action>& action) const override;
+
+  //In place moves - a Move is the column to drop the next counter in
+  bool supportsInPlaceMoves() const override { return true; }
+  std::shared_ptr<State> cloneState(const std::shared_ptr<State>& state) const override;
+  std::size_t generateMoves(const std::shared_ptr<State>& state, MoveBuffer& moves) const override;
+  void makeMove(const std::shared_ptr<State>& state, Move move) const override;
+  void unmakeMove(const std::shared_ptr<State>& state, Move move) const override;
+  std::shared_ptr<Action> getMoveAction(const std::shared_ptr<State>& state, Move move) const override;
+  int getMoveId(Move move) const override { return move; }
+  int getMoveScore(const std::shared_ptr<State>& state, Move move) const override;
+  //Rollouts take a win when there is one and otherwise block the opponent's, playing at random when neither comes up
+  std::size_t chooseRolloutMove(const std::shared_ptr<State>& state, const MoveBuffer& moves, std::size_t moveCount, std::uint64_t random) const override;
+
+  void printState(const std::shared_ptr<State>& state) const override;
+  void printAction(const std::shared_ptr<Action>& action) const override;
+
+  friend std::ostream& operator<< (std::ostream &out, const ConnectFour& connectFourGame);
+
+private:
+  ConnectFourBoard board;
+  Player currentPlayer;
+};
+
+std::ostream& operator<< (std::ostream &out, const ConnectFour& connectFourGame);
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef CONNECT_FOUR_BOARD_H_
+#define CONNECT_FOUR_BOARD_H_
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+#include "Player.hpp"
+#include "MiniMax.hpp"
+
+//Bitboard for a 7x6 board - each column takes 7 bits, bottom row first, with the top bit of each column always empty so that lines cannot wrap between columns
+//Bit column * 7 + row of each mask is set when that player has a counter there
+struct ConnectFourBoard
+{
+  static constexpr int COLUMNS = 7;
+  static constexpr int ROWS = 6;
+  static constexpr int COLUMN_BITS = ROWS + 1;
+  static constexpr int CELLS = COLUMNS * ROWS;
+
+  //Centre columns take part in more lines so are tried first
+  static constexpr std::array<int, COLUMNS> COLUMN_ORDER = {3, 2, 4, 1, 5, 0, 6};
+
+  static constexpr ZobristKeys<COLUMNS * COLUMN_BITS, 2> ZOBRIST_KEYS = ZobristKeys<COLUMNS * COLUMN_BITS, 2>();
+
+  std::uint64_t reds = 0;
+  std::uint64_t yellows = 0;
+  std::array<std::uint8_t, COLUMNS> heights = {};
+  int moveCount = 0;
+  //Zobrist hashes of the position and of its reflection left to right - kept up to date by place() and remove()
+  std::uint64_t hash = 0;
+  std::uint64_t mirroredHash = 0;
+
+  static constexpr int getBit(const int column, const int row) { return column * COLUMN_BITS + row; }
+
+  //Shifting a mask by these moves every counter one step along a vertical, horizontal, diagonal or anti-diagonal line
+  static constexpr bool hasLine(const std::uint64_t mask)
+  {
+    for (int direction : {1, COLUMN_BITS, COLUMN_BITS - 1, COLUMN_BITS + 1})
+    {
+      std::uint64_t pairs = mask & (mask >> direction);
+      if (pairs & (pairs >> (2 * direction)))
+        return true;
+    }
+    return false;
+  }
+
+  static constexpr char getCounter(const Player player) { return (player == Player::Player1) ? 'R' : 'Y'; }
+
+  constexpr std::uint64_t getMask(const Player player) const { return (player == Player::Player1) ? reds : yellows; }
+  constexpr bool canPlay(const int column) const { return column >= 0 && column < COLUMNS && heights[column] < ROWS; }
+  constexpr bool isFull() const { return moveCount == CELLS; }
+
+  constexpr bool checkWinner(const Player player) const { return hasLine(getMask(player)); }
+  constexpr bool checkEndOfGame() const { return isFull() || hasLine(reds) || hasLine(yellows); }
+
+  //Player1 always moves first
+  constexpr Player getPlayerToMove() const { return (moveCount % 2 == 0) ? Player::Player1 : Player::Player2; }
+
+  constexpr void place(const int column, const Player player)
+  {
+    int row = heights[column]++;
+    int bit = getBit(column, row);
+    if (player == Player::Player1)
+      reds |= std::uint64_t(1) << bit;
+    else
+      yellows |= std::uint64_t(1) << bit;
+    hash ^= ZOBRIST_KEYS.get(bit, (player == Player::Player1) ? 0 : 1);
+    mirroredHash ^= ZOBRIST_KEYS.get(getBit(COLUMNS - 1 - column, row), (player == Player::Player1) ? 0 : 1);
+    moveCount++;
+  }
+
+  //Undoes place() - takes the top counter off the column
+  constexpr void remove(const int column, const Player player)
+  {
+    int row = --heights[column];
+    int bit = getBit(column, row);
+    if (player == Player::Player1)
+      reds &= ~(std::uint64_t(1) << bit);
+    else
+      yellows &= ~(std::uint64_t(1) << bit);
+    hash ^= ZOBRIST_KEYS.get(bit, (player == Player::Player1) ? 0 : 1);
+    mirroredHash ^= ZOBRIST_KEYS.get(getBit(COLUMNS - 1 - column, row), (player == Player::Player1) ? 0 : 1);
+    moveCount--;
+  }
+
+  //The smaller of the hashes of the board and its reflection, with symmetry 1 when the reflection is the canonical one
+  constexpr std::uint64_t getCanonicalHash(int& symmetry) const
+  {
+    symmetry = (mirroredHash < hash) ? 1 : 0;
+    return (mirroredHash < hash) ? mirroredHash : hash;
+  }
+
+  constexpr char at(const int column, const int row) const
+  {
+    std::uint64_t bit = std::uint64_t(1) << getBit(column, row);
+    if (reds & bit)
+      return 'R';
+    if (yellows & bit)
+      return 'Y';
+    return '-';
+  }
+
+  constexpr bool operator==(const ConnectFourBoard& rhs) const { return hash == rhs.hash && reds == rhs.reds && yellows == rhs.yellows; }
+};
+
+#endif
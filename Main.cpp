@@ -1,11 +1,29 @@
 #include <iostream>
 
 #include "PlayTicTacToe.hpp"
+#include "PlayConnectFour.hpp"
 
 int main()
 {
-  PlayTicTacToe play(PlayTicTacToe::PlayPolicy::SINGLEPLAYER);
-  play.play();
+  char game = 't';
+  std::cout << "Would you like to play tic-tac-toe or connect four (t,c)? " << std::flush;
+  std::cin >> game;
+
+  if (game == 'c')
+  {
+    PlayConnectFour play(PlayConnectFour::PlayPolicy::SINGLEPLAYER);
+    play.play();
+  }
+  else
+  {
+    //only the search ponders, the oracle already knows every answer
+    char engine = 'o';
+    std::cout << "Should the computer look its moves up in the solved game, or search them and ponder during your turns (o,s)? " << std::flush;
+    std::cin >> engine;
+
+    PlayTicTacToe play(PlayTicTacToe::PlayPolicy::SINGLEPLAYER, (engine == 's') ? PlayTicTacToe::Engine::MINIMAX : PlayTicTacToe::Engine::ORACLE);
+    play.play();
+  }
 
   /* std::array<char, 9> arr = {
     '-', '-', '-',
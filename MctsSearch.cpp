@@ -0,0 +1,280 @@
+#include "MctsSearch.hpp"
+
+#include <thread>
+#include <cmath>
+#include <algorithm>
+
+MctsSearch::MctsSearch(const std::shared_ptr<const SearchableGame>& game, std::size_t maxNodes)
+  : game(game), player(game->getPlayerFromState(game->getState())), maxNodes(std::clamp<std::size_t>(maxNodes, 1, NO_NODE)),
+    nodeCount(0), useInPlaceMoves(false), explorationConstant(std::sqrt(2.0)), rolloutPolicy(RolloutPolicy::RANDOM), seed(0),
+    iterationBudget(0), hasDeadline(false), deadline(), stopRequested(false), iterationCount(0) {}
+
+ActionValue MctsSearch::performSearch(const std::shared_ptr<State>& state, std::chrono::milliseconds timeBudget, int threadCount)
+{
+  Limits limits;
+  limits.time = timeBudget;
+  return performSearch(state, limits, threadCount);
+}
+
+ActionValue MctsSearch::performSearch(const std::shared_ptr<State>& state, const Limits& limits, int threadCount)
+{
+  threadCount = std::max(threadCount, 1);
+  useInPlaceMoves = game->supportsInPlaceMoves();
+  player = game->getPlayerFromState(state);
+
+  iterationBudget = limits.iterations;
+  hasDeadline = limits.time > std::chrono::milliseconds::zero();
+  deadline = std::chrono::steady_clock::now() + limits.time;
+  if (iterationBudget == 0 && !hasDeadline)
+    iterationBudget = DEFAULT_ITERATIONS;
+  stopRequested.store(false, std::memory_order_relaxed);
+  iterationCount.store(0, std::memory_order_relaxed);
+
+  //the tree is rebuilt for every search, so starting again is just a matter of taking the pool back
+  if (!nodes)
+    nodes.reset(new Node[maxNodes]);
+  nodeCount.store(0, std::memory_order_relaxed);
+  initialiseNode(allocateNodes(1), 0);
+  if (!useInPlaceMoves)
+  {
+    nodeStates.resize(maxNodes);
+    nodeActions.resize(maxNodes);
+    nodeStates[0] = state;
+  }
+
+  std::vector<SearchThread> threads(threadCount);
+  for (int i = 0; i < threadCount; ++i)
+  {
+    threads[i].random.seed(seed + i);
+    if (useInPlaceMoves)
+      threads[i].state = game->cloneState(state);
+  }
+
+  std::vector<std::thread> helpers;
+  for (int i = 1; i < threadCount; ++i)
+    helpers.emplace_back(&MctsSearch::runIterations, this, std::ref(threads[i]));
+  runIterations(threads[0]);
+  for (std::thread& helper : helpers)
+    helper.join();
+
+  //the most visited child is the most reliable choice - the child with the best mean result can be one that was hardly tried
+  ActionValue result = {nullptr, 0};
+  const Node& root = nodes[0];
+  if (root.expansion.load(std::memory_order_relaxed) == EXPANDED)
+  {
+    std::uint32_t best = root.firstChild;
+    for (std::uint32_t child = root.firstChild; child < root.firstChild + root.childCount; ++child)
+    {
+      if (nodes[child].visits.load(std::memory_order_relaxed) > nodes[best].visits.load(std::memory_order_relaxed))
+        best = child;
+    }
+
+    std::uint32_t visits = nodes[best].visits.load(std::memory_order_relaxed);
+    double meanReward = (visits > 0) ? static_cast<double>(nodes[best].rewards.load(std::memory_order_relaxed)) / visits : 1.0;
+    result.action = useInPlaceMoves ? game->getMoveAction(state, nodes[best].move) : nodeActions[best];
+    result.value = static_cast<int>(std::lround((meanReward - 1.0) * VALUE_SCALE));
+  }
+
+  if (!useInPlaceMoves)
+  {
+    std::size_t used = nodeCount.load(std::memory_order_relaxed);
+    std::fill(nodeStates.begin(), nodeStates.begin() + used, nullptr);
+    std::fill(nodeActions.begin(), nodeActions.begin() + used, nullptr);
+  }
+
+  return result;
+}
+
+void MctsSearch::runIterations(SearchThread& thread)
+{
+  while (!stopRequested.load(std::memory_order_relaxed))
+  {
+    std::uint64_t iteration = iterationCount.fetch_add(1, std::memory_order_relaxed);
+    if (iterationBudget > 0 && iteration >= iterationBudget)
+    {
+      iterationCount.fetch_sub(1, std::memory_order_relaxed);
+      break;
+    }
+
+    iterate(thread);
+
+    if (hasDeadline && iteration % DEADLINE_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= deadline)
+      stopRequested.store(true, std::memory_order_relaxed);
+  }
+}
+
+void MctsSearch::iterate(SearchThread& thread)
+{
+  thread.path.clear();
+  thread.moves.clear();
+
+  auto descend = [this, &thread](std::uint32_t index)
+  {
+    thread.path.push_back(index);
+    nodes[index].virtualLosses.fetch_add(1, std::memory_order_relaxed);
+    if (useInPlaceMoves)
+    {
+      game->makeMove(thread.state, nodes[index].move);
+      thread.moves.push_back(nodes[index].move);
+    }
+  };
+
+  //selection - follow UCT down through the nodes that already have children
+  std::uint32_t index = 0;
+  thread.path.push_back(index);
+  nodes[index].virtualLosses.fetch_add(1, std::memory_order_relaxed);
+  while (nodes[index].expansion.load(std::memory_order_acquire) == EXPANDED)
+  {
+    index = selectChild(nodes[index]);
+    descend(index);
+  }
+
+  //expansion - a leaf that does not end the game gets its children, and the rollout starts from the one UCT picks first
+  if (!game->terminalState(useInPlaceMoves ? thread.state : nodeStates[index]) && expand(thread, index))
+  {
+    index = selectChild(nodes[index]);
+    descend(index);
+  }
+
+  int reward = rollout(thread, useInPlaceMoves ? thread.state : nodeStates[index]);
+
+  //the root's player made the moves into the nodes an odd number of plies down
+  for (std::size_t ply = 0; ply < thread.path.size(); ++ply)
+  {
+    Node& node = nodes[thread.path[ply]];
+    node.rewards.fetch_add((ply % 2 == 1) ? reward : 2 - reward, std::memory_order_relaxed);
+    node.visits.fetch_add(1, std::memory_order_relaxed);
+    node.virtualLosses.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  for (auto move = thread.moves.rbegin(); move != thread.moves.rend(); ++move)
+    game->unmakeMove(thread.state, *move);
+}
+
+std::uint32_t MctsSearch::selectChild(const Node& node) const
+{
+  double parentVisits = node.visits.load(std::memory_order_relaxed) + node.virtualLosses.load(std::memory_order_relaxed);
+  double logParentVisits = std::log(std::max(parentVisits, 1.0));
+
+  std::uint32_t best = node.firstChild;
+  double bestScore = -1.0;
+  for (std::uint32_t child = node.firstChild; child < node.firstChild + node.childCount; ++child)
+  {
+    const Node& candidate = nodes[child];
+    //virtual losses count as visits that won nothing
+    std::uint32_t visits = candidate.visits.load(std::memory_order_relaxed) + candidate.virtualLosses.load(std::memory_order_relaxed);
+    //children yet to be tried come first, in the order the game generated them
+    if (visits == 0)
+      return child;
+
+    double meanReward = static_cast<double>(candidate.rewards.load(std::memory_order_relaxed)) / (2.0 * visits);
+    double score = meanReward + explorationConstant * std::sqrt(logParentVisits / visits);
+    if (score > bestScore)
+    {
+      best = child;
+      bestScore = score;
+    }
+  }
+
+  return best;
+}
+
+bool MctsSearch::expand(SearchThread& thread, std::uint32_t index)
+{
+  //if another thread is already expanding the leaf this iteration rolls out from the leaf itself
+  Node& node = nodes[index];
+  std::uint8_t expected = UNEXPANDED;
+  if (!node.expansion.compare_exchange_strong(expected, EXPANDING, std::memory_order_acquire))
+    return false;
+
+  Successors successors;
+  std::size_t childCount;
+  if (useInPlaceMoves)
+  {
+    childCount = game->generateMoves(thread.state, thread.moveBuffer);
+  }
+  else
+  {
+    successors = game->successorStates(nodeStates[index]);
+    childCount = successors.size();
+  }
+
+  std::uint32_t firstChild = (childCount > 0) ? allocateNodes(childCount) : NO_NODE;
+  if (firstChild == NO_NODE)
+  {
+    node.expansion.store(UNEXPANDED, std::memory_order_relaxed);
+    return false;
+  }
+
+  for (std::size_t i = 0; i < childCount; ++i)
+  {
+    std::uint32_t child = firstChild + static_cast<std::uint32_t>(i);
+    initialiseNode(child, useInPlaceMoves ? thread.moveBuffer[i] : 0);
+    if (!useInPlaceMoves)
+    {
+      nodeStates[child] = successors[i].first;
+      nodeActions[child] = successors[i].second;
+    }
+  }
+
+  node.firstChild = firstChild;
+  node.childCount = static_cast<std::uint16_t>(childCount);
+  node.expansion.store(EXPANDED, std::memory_order_release);
+  return true;
+}
+
+std::uint32_t MctsSearch::allocateNodes(std::size_t count)
+{
+  std::size_t first = nodeCount.load(std::memory_order_relaxed);
+  do
+  {
+    if (first + count > maxNodes)
+      return NO_NODE;
+  } while (!nodeCount.compare_exchange_weak(first, first + count, std::memory_order_relaxed));
+
+  return static_cast<std::uint32_t>(first);
+}
+
+void MctsSearch::initialiseNode(std::uint32_t index, Move move)
+{
+  Node& node = nodes[index];
+  node.firstChild = NO_NODE;
+  node.childCount = 0;
+  node.expansion.store(UNEXPANDED, std::memory_order_relaxed);
+  node.move = move;
+  node.visits.store(0, std::memory_order_relaxed);
+  node.virtualLosses.store(0, std::memory_order_relaxed);
+  node.rewards.store(0, std::memory_order_relaxed);
+}
+
+int MctsSearch::rollout(SearchThread& thread, std::shared_ptr<State> state)
+{
+  if (useInPlaceMoves)
+  {
+    //the moves are unmade along with the ones made on the way down
+    while (!game->terminalState(state))
+    {
+      std::size_t moveCount = game->generateMoves(state, thread.moveBuffer);
+      std::uint64_t random = thread.random();
+      std::size_t choice = (rolloutPolicy == RolloutPolicy::GAME) ? game->chooseRolloutMove(state, thread.moveBuffer, moveCount, random) : random % moveCount;
+      Move move = thread.moveBuffer[choice];
+      game->makeMove(state, move);
+      thread.moves.push_back(move);
+    }
+    return getReward(state);
+  }
+
+  while (!game->terminalState(state))
+  {
+    Successors successors = game->successorStates(state);
+    state = successors[thread.random() % successors.size()].first;
+  }
+  return getReward(state);
+}
+
+int MctsSearch::getReward(const std::shared_ptr<State>& state) const
+{
+  //only who won counts, not by how much
+  int utility = game->getUtility(state, player);
+  return (utility > 0) ? 2 : (utility == 0) ? 1 : 0;
+}
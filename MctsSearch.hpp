@@ -0,0 +1,126 @@
+#ifndef MCTS_SEARCH_H_
+#define MCTS_SEARCH_H_
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <limits.h>
+
+#include "MiniMax.hpp"
+
+//Monte Carlo tree search of a SearchableGame - grows a tree from the root by UCT and scores each leaf it adds by playing the game out to the end
+//Only terminalState and getUtility are used to value positions, so unlike a depth limited MiniMaxSearch it needs no evaluation function
+//Its results are ActionValues like MiniMaxSearch's so either engine can choose a player's moves
+class MctsSearch
+{
+public:
+  //RANDOM plays every rollout move uniformly at random, GAME asks SearchableGame::chooseRolloutMove for them
+  //Games without in place moves always roll out at random
+  enum class RolloutPolicy
+  {
+    RANDOM,
+    GAME
+  };
+
+  //Budget for a search - zero means no limit, and with neither limit set the search runs DEFAULT_ITERATIONS iterations
+  struct Limits
+  {
+    std::uint64_t iterations = 0;
+    std::chrono::milliseconds time = std::chrono::milliseconds::zero();
+  };
+
+  static constexpr std::uint64_t DEFAULT_ITERATIONS = 10000;
+  static constexpr std::size_t DEFAULT_MAX_NODES = std::size_t(1) << 20;
+  //The value of a result is the chosen action's mean rollout result for the player to move, from -VALUE_SCALE for always lost to VALUE_SCALE for always won
+  static constexpr int VALUE_SCALE = 1000;
+
+  //maxNodes is the size of the node pool, allocated by the first search - once the tree fills it the search carries on without adding nodes
+  MctsSearch(const std::shared_ptr<const SearchableGame>& game, std::size_t maxNodes = DEFAULT_MAX_NODES);
+
+  //Returns the root's most visited action
+  //With more than one thread the threads all grow the same tree, and each node a thread is in the middle of has a virtual loss added so that the others explore elsewhere
+  ActionValue performSearch(const std::shared_ptr<State>& state, const Limits& limits, int threadCount = 1);
+  ActionValue performSearch(const std::shared_ptr<State>& state, std::chrono::milliseconds timeBudget, int threadCount = 1);
+
+  //Safe to call from another thread - ends the search in progress, which returns the best action found so far
+  void stop() { stopRequested.store(true, std::memory_order_relaxed); }
+
+  void setExplorationConstant(double constant) { explorationConstant = constant; }
+  void setRolloutPolicy(RolloutPolicy policy) { rolloutPolicy = policy; }
+  //Searches with the same seed, budget of iterations and single thread make the same choices
+  void setSeed(std::uint64_t newSeed) { seed = newSeed; }
+
+  //Iterations run and nodes added to the tree by the last search
+  std::uint64_t getIterations() const { return iterationCount.load(std::memory_order_relaxed); }
+  std::size_t getNodeCount() const { return nodeCount.load(std::memory_order_relaxed); }
+
+private:
+  static constexpr std::uint32_t NO_NODE = UINT32_MAX;
+  //iterations between checks of the clock
+  static constexpr std::uint64_t DEADLINE_CHECK_INTERVAL = 64;
+
+  enum Expansion : std::uint8_t
+  {
+    UNEXPANDED,
+    EXPANDING,
+    EXPANDED
+  };
+
+  //The children of a node are allocated together so they sit next to each other in the pool
+  //rewards are counted in half points for the player who made the move into the node - 2 for a win and 1 for a draw
+  struct Node
+  {
+    std::uint32_t firstChild;
+    std::uint16_t childCount;
+    std::atomic<std::uint8_t> expansion;
+    Move move;
+    std::atomic<std::uint32_t> visits;
+    std::atomic<std::uint32_t> virtualLosses;
+    std::atomic<std::uint64_t> rewards;
+  };
+
+  //Everything one search thread modifies - threads searching together share only the tree
+  struct SearchThread
+  {
+    std::mt19937_64 random;
+    //a clone of the root which each iteration makes its moves on and unmakes them from afterwards, for games with in place moves
+    std::shared_ptr<State> state;
+    std::vector<std::uint32_t> path;
+    std::vector<Move> moves;
+    SearchableGame::MoveBuffer moveBuffer;
+  };
+
+  std::shared_ptr<const SearchableGame> game;
+  Player player;
+  std::size_t maxNodes;
+  std::unique_ptr<Node[]> nodes;
+  //for games without in place moves every node keeps its state, and the root's children their actions
+  std::vector<std::shared_ptr<State>> nodeStates;
+  std::vector<std::shared_ptr<Action>> nodeActions;
+  std::atomic<std::size_t> nodeCount;
+  bool useInPlaceMoves;
+
+  double explorationConstant;
+  RolloutPolicy rolloutPolicy;
+  std::uint64_t seed;
+
+  std::uint64_t iterationBudget;
+  bool hasDeadline;
+  std::chrono::steady_clock::time_point deadline;
+  std::atomic<bool> stopRequested;
+  std::atomic<std::uint64_t> iterationCount;
+
+  void runIterations(SearchThread& thread);
+  void iterate(SearchThread& thread);
+  std::uint32_t selectChild(const Node& node) const;
+  bool expand(SearchThread& thread, std::uint32_t index);
+  std::uint32_t allocateNodes(std::size_t count);
+  void initialiseNode(std::uint32_t index, Move move);
+  int rollout(SearchThread& thread, std::shared_ptr<State> state);
+  int getReward(const std::shared_ptr<State>& state) const;
+};
+
+#endif
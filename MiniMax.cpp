@@ -4,6 +4,7 @@
 #include <exception>
 #include <iostream>
 #include <algorithm>
+#include <thread>
 
 ActionValue MiniMaxSearch::performSearch()
 { 
@@ -30,311 +31,1010 @@ ActionValue MiniMaxSearch::performSearch(const std::shared_ptr<State>& state, co
 
 ActionValue MiniMaxSearch::performSearch(const std::shared_ptr<State>& state, const std::vector<Options>& options, int depth)
 {
-  player = game->getPlayerFromState(state);
-  depthLimit = depth;
-  int currentDepth = 0;
-  ActionValue actionValue;
-  transpositionTable.clear();
+  beginSearch(state, options, 1);
+  auto start = std::chrono::steady_clock::now();
+  ActionValue actionValue = useMtdf ? searchWithMtdf(threads[0], state, depth, getMtdfGuess()) : searchToDepth(threads[0], state, depth, -INFINITE_VALUE, INFINITE_VALUE);
+  if constexpr (SEARCH_STATS_ENABLED)
+    threads[0].stats.countIteration(depth, threads[0].nodesVisited, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+  return endSearch(actionValue);
+}
+
+ActionValue MiniMaxSearch::performSearch(const std::shared_ptr<State>& state, const std::vector<Options>& options, const Limits& limits)
+{
+  return performSearch(state, options, limits, 1);
+}
+
+ActionValue MiniMaxSearch::performSearch(const std::shared_ptr<State>& state, const std::vector<Options>& options, std::chrono::milliseconds timeBudget)
+{
+  Limits limits;
+  limits.time = timeBudget;
+  return performSearch(state, options, limits, 1);
+}
+
+ActionValue MiniMaxSearch::performSearch(const std::vector<Options>& options, const Limits& limits)
+{
+  return performSearch(game->getState(), options, limits, 1);
+}
+
+ActionValue MiniMaxSearch::performSearch(const std::shared_ptr<State>& state, const std::vector<Options>& options, const Limits& limits, int threadCount)
+{
+  stopRequested.store(false, std::memory_order_relaxed);
+  return searchWithLimits(state, options, limits, threadCount);
+}
 
-  if (std::find(options.begin(), options.end(), Options::USE_TRANSPOSITION_TABLE) != options.end())
+MiniMaxSearch::SearchHandle MiniMaxSearch::startSearch(const std::shared_ptr<State>& state, const std::vector<Options>& options, const Limits& limits, int threadCount)
+{
+  //cleared before the search starts so that a stop() made before the search thread gets going is not lost
+  stopRequested.store(false, std::memory_order_relaxed);
   {
-    if (std::find(options.begin(), options.end(), Options::USE_PRUNING) != options.end())
-      actionValue = maxValueWithTranspositionTableAndPruning(state, INT_MIN, INT_MAX, currentDepth);
-    else
-      actionValue = maxValueWithTranspositionTable(state, currentDepth);
+    std::lock_guard<std::mutex> lock(bestSoFarMutex);
+    bestSoFar = {nullptr, 0};
   }
-  else
+
+  return SearchHandle(*this, std::async(std::launch::async, &MiniMaxSearch::searchWithLimits, this, state, options, limits, threadCount));
+}
+
+ActionValue MiniMaxSearch::getBestSoFar() const
+{
+  std::lock_guard<std::mutex> lock(bestSoFarMutex);
+  return bestSoFar;
+}
+
+MiniMaxSearch::~MiniMaxSearch()
+{
+  //a ponder search still running reads members declared after its handle, so it is stopped and joined before any of them are destroyed
+  ponderSearch.reset();
+}
+
+MiniMaxSearch::SearchHandle::~SearchHandle()
+{
+  if (result.valid())
   {
-    if (std::find(options.begin(), options.end(), Options::USE_PRUNING) != options.end())
-      actionValue = maxValueWithPruning(state, INT_MIN, INT_MAX, currentDepth);
-    else
-      actionValue = maxValue(state, currentDepth);
+    stop();
+    result.wait();
   }
-  
-  depthLimit = -1;
-  return actionValue;
 }
 
-ActionValue MiniMaxSearch::performSearch(const std::vector<Options>& options)
+bool MiniMaxSearch::SearchHandle::isFinished() const
 {
-  return performSearch(game->getState(), options, -1);
+  return !result.valid() || result.wait_for(std::chrono::seconds::zero()) == std::future_status::ready;
 }
 
-ActionValue MiniMaxSearch::performSearch(const std::vector<Options>& options, int depth)
+bool MiniMaxSearch::SearchHandle::waitFor(std::chrono::milliseconds timeout) const
 {
-  return performSearch(game->getState(), options, depth);
+  return !result.valid() || result.wait_for(timeout) == std::future_status::ready;
 }
 
-ActionValue MiniMaxSearch::performSearch(int depth)
+ActionValue MiniMaxSearch::SearchHandle::get()
 {
-  std::vector<Options> options;
-  return performSearch(game->getState(), options, depth);
+  return result.get();
 }
 
-ActionValue MiniMaxSearch::maxValue(const std::shared_ptr<State>& state, int currentDepth)
+void MiniMaxSearch::startPondering(const std::shared_ptr<State>& state, const std::vector<Options>& options, const Limits& limits, int threadCount)
 {
-  currentDepth++;
-  if (game->terminalState(state))
-    return {nullptr, game->getUtility(state, player)};
+  ponderSearch.reset();
+  ponderOptions = options;
+  ponderLimits = limits;
+  ponderThreadCount = threadCount;
 
-  if (depthLimit != -1)
-    if (currentDepth >= depthLimit)
-      return {nullptr, game->getEvaluationValue(state, player)};
-  
-  ActionValue actionValue;
-  actionValue.action = nullptr;
-  actionValue.value = INT_MIN;
+  //the ponder search has until the opponent moves
+  Limits ponderSearchLimits = limits;
+  ponderSearchLimits.time = std::chrono::milliseconds::zero();
 
-  for (auto successor : game->successorStates(state))
+  ponderState = predictReply(state);
+  ponderStart = std::chrono::steady_clock::now();
+  ponderSearch = std::make_unique<SearchHandle>(startSearch(ponderState ? ponderState : state, options, ponderSearchLimits, threadCount));
+}
+
+ActionValue MiniMaxSearch::finishPondering(const std::shared_ptr<State>& state)
+{
+  ActionValue actionValue;
+  if (ponderState && *ponderState == state)
+  {
+    if (ponderLimits.time > std::chrono::milliseconds::zero())
+    {
+      auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(ponderStart + ponderLimits.time - std::chrono::steady_clock::now());
+      if (!ponderSearch->waitFor(std::max(remaining, std::chrono::milliseconds::zero())))
+        ponderSearch->stop();
+    }
+    actionValue = ponderSearch->get();
+    ponderSearch.reset();
+  }
+  else
   {
-    std::shared_ptr<State> state = successor.first;
+    ponderSearch.reset();
+    actionValue = performSearch(state, ponderOptions, ponderLimits, ponderThreadCount);
+  }
+
+  ponderState = nullptr;
+  return actionValue;
+}
+
+std::shared_ptr<State> MiniMaxSearch::predictReply(const std::shared_ptr<State>& state) const
+{
+  //the previous search stored the opponent's best reply when it searched this state as one of the root's children
+  if (!useTranspositionTable || game->terminalState(state))
+    return nullptr;
+
+  int symmetry = 0;
+  std::uint64_t key = useSymmetry ? state->getCanonicalHash(symmetry) : state->getHash();
+  TranspositionTable::Entry entry;
+  if (!transpositionTable->probe(key, entry) || entry.bestMove == TranspositionTable::NO_MOVE)
+    return nullptr;
 
-    ActionValue newActionValue = minValue(state, currentDepth);
-    newActionValue.action = successor.second;
+  Children children;
+  generateChildren(state, children, 0);
+  int moveIndex = useSymmetry ? findChild(children, state->mapActionId(entry.bestMove, symmetry, false)) : entry.bestMove;
+  if (moveIndex < 0 || moveIndex >= static_cast<int>(children.size()))
+    return nullptr;
+
+  if (!children.inPlace)
+    return children.successors[moveIndex].first;
+
+  std::shared_ptr<State> reply = game->cloneState(state);
+  game->makeMove(reply, children.moves[moveIndex]);
+  return reply;
+}
+
+ActionValue MiniMaxSearch::searchWithLimits(const std::shared_ptr<State>& state, const std::vector<Options>& options, const Limits& limits, int threadCount)
+{
+  beginSearch(state, options, std::max(threadCount, 1));
+  nodeBudget = limits.nodes;
+  hasDeadline = limits.time > std::chrono::milliseconds::zero();
+  deadline = std::chrono::steady_clock::now() + limits.time;
 
-    if (newActionValue.value > actionValue.value)
-      actionValue = newActionValue;
+  //lazy SMP - helper threads run their own iterative deepening on the same root and mostly contribute by filling the shared transposition table
+  //young brothers wait has a single iterative deepening search whose subtrees are shared out to the pool's threads instead
+  std::vector<std::thread> helpers;
+  for (std::size_t i = 1; i < threads.size() && !useYoungBrothersWait; ++i)
+    helpers.emplace_back(&MiniMaxSearch::iterativeDeepening, this, std::ref(threads[i]), state, std::cref(limits));
+
+  iterativeDeepening(threads[0], state, limits);
+
+  helpersStop.store(true, std::memory_order_relaxed);
+  for (std::thread& helper : helpers)
+    helper.join();
+
+  //take the deepest completed iteration of any thread, preferring the main thread on a tie
+  const SearchThread* bestThread = &threads[0];
+  for (const SearchThread& thread : threads)
+  {
+    if (thread.completedDepth > bestThread->completedDepth && thread.result.action)
+      bestThread = &thread;
   }
 
-  return actionValue;
+  return endSearch(bestThread->result);
 }
 
-ActionValue MiniMaxSearch::minValue(const std::shared_ptr<State>& state, int currentDepth)
+std::vector<ActionValue> MiniMaxSearch::searchBatch(const std::vector<std::shared_ptr<State>>& states)
 {
-  currentDepth++;
-  if (game->terminalState(state))
-    return {nullptr, game->getUtility(state, player)};
+  std::vector<Options> options;
+  return searchBatch(states, options, Limits(), std::max(static_cast<int>(std::thread::hardware_concurrency()), 1), false);
+}
 
-  if (depthLimit != -1)
-    if (currentDepth >= depthLimit)
-      return {nullptr, game->getEvaluationValue(state, player)};
-  
-  ActionValue actionValue;
-  actionValue.action = nullptr;
-  actionValue.value = INT_MAX;
+std::vector<ActionValue> MiniMaxSearch::searchBatch(const std::vector<std::shared_ptr<State>>& states, const std::vector<Options>& options, int depth)
+{
+  Limits limits;
+  limits.depth = depth;
+  return searchBatch(states, options, limits, std::max(static_cast<int>(std::thread::hardware_concurrency()), 1), false);
+}
+
+std::vector<ActionValue> MiniMaxSearch::searchBatch(const std::vector<std::shared_ptr<State>>& states, const std::vector<Options>& options, const Limits& limits, int threadCount, bool shareTranspositionTable)
+{
+  threadCount = std::max(threadCount, 1);
+  if (!pool || pool->getThreadCount() != threadCount)
+    pool = std::make_unique<WorkStealingPool>(threadCount);
 
-  for (auto successor : game->successorStates(state))
+  //a search for each of the pool's threads, which has a table of its own the same size as this one's unless the table is shared
+  std::size_t transpositionTableSizeMB = std::max<std::size_t>(transpositionTable->getSizeBytes() / (1024 * 1024), 1);
+  while (static_cast<int>(batchSearches.size()) < threadCount)
+    batchSearches.push_back(std::make_unique<MiniMaxSearch>(game, shareTranspositionTable ? 1 : transpositionTableSizeMB));
+
+  //every batch starts from empty tables, and the searches sharing a table leave it on a single generation rather than each starting a new one
+  if (shareTranspositionTable)
+    transpositionTable->clear();
+  for (std::unique_ptr<MiniMaxSearch>& batchSearch : batchSearches)
   {
-    std::shared_ptr<State> state = successor.first;
-    ActionValue newActionValue = maxValue(state, currentDepth);
-    newActionValue.action = successor.second;
+    if (shareTranspositionTable)
+      batchSearch->transpositionTable = transpositionTable;
+    else if (batchSearch->transpositionTable == transpositionTable)
+      batchSearch->transpositionTable = std::make_shared<TranspositionTable>(transpositionTableSizeMB);
+    else
+      batchSearch->newGame();
+    batchSearch->ageTranspositionTable = !shareTranspositionTable;
+    batchSearch->aspirationWindow = aspirationWindow;
+    batchSearch->positionCache = positionCache;
+  }
 
-    if (newActionValue.value < actionValue.value)
-      actionValue = newActionValue;
+  std::vector<ActionValue> results(states.size());
+  std::atomic<std::uint64_t> nodesVisited(0);
+  WorkStealingPool::TaskGroup group;
+  for (std::size_t i = 0; i < states.size(); ++i)
+  {
+    pool->submit(group, [this, &states, &options, &limits, &results, &nodesVisited, i]()
+    {
+      MiniMaxSearch& batchSearch = *batchSearches[pool->getCurrentWorker()];
+      results[i] = batchSearch.performSearch(states[i], options, limits, 1);
+      nodesVisited.fetch_add(batchSearch.getNodesVisited(), std::memory_order_relaxed);
+    });
   }
+  pool->wait(group);
 
-  return actionValue;
+  threads.clear();
+  threads.resize(1);
+  threads[0].nodesVisited = nodesVisited.load();
+  return results;
 }
 
-ActionValue MiniMaxSearch::maxValueWithPruning(const std::shared_ptr<State>& state, int alpha, int beta, int currentDepth)
+std::uint64_t MiniMaxSearch::getNodesVisited() const
 {
-  currentDepth++;
-  if (game->terminalState(state))
-    return {nullptr, game->getUtility(state, player)};
+  std::uint64_t nodesVisited = 0;
+  for (const SearchThread& thread : threads)
+    nodesVisited += thread.nodesVisited;
+  return nodesVisited;
+}
 
-  if (depthLimit != -1)
-    if (currentDepth >= depthLimit)
-      return {nullptr, game->getEvaluationValue(state, player)};
-  
-  ActionValue actionValue;
-  actionValue.action = nullptr;
-  actionValue.value = INT_MIN;
+std::uint64_t MiniMaxSearch::getTranspositionTableProbes() const
+{
+  std::uint64_t probes = 0;
+  for (const SearchThread& thread : threads)
+    probes += thread.transpositionProbes;
+  return probes;
+}
 
-  for (auto successor : game->successorStates(state))
-  {
-    std::shared_ptr<State> state = successor.first;
+std::uint64_t MiniMaxSearch::getTranspositionTableHits() const
+{
+  std::uint64_t hits = 0;
+  for (const SearchThread& thread : threads)
+    hits += thread.transpositionHits;
+  return hits;
+}
+
+std::size_t MiniMaxSearch::getSearchArenaPeakBytes() const
+{
+  std::size_t bytes = 0;
+  for (const std::unique_ptr<SearchArena>& arena : arenas)
+    bytes += arena->getPeakBytesInUse();
+  return bytes;
+}
 
-    ActionValue newActionValue = minValueWithPruning(state, alpha, beta, currentDepth);
-    newActionValue.action = successor.second;
+std::size_t MiniMaxSearch::getSearchArenaBytesReserved() const
+{
+  std::size_t bytes = 0;
+  for (const std::unique_ptr<SearchArena>& arena : arenas)
+    bytes += arena->getBytesReserved();
+  return bytes;
+}
 
-    if (newActionValue.value > actionValue.value)
-      actionValue = newActionValue;
+void MiniMaxSearch::savePositionCache(const std::string& path) const
+{
+  std::vector<TranspositionTable::Entry> entries = transpositionTable->getEntries();
+  std::vector<PositionCache::FileEntry> fileEntries;
+  fileEntries.reserve(entries.size());
+  for (const TranspositionTable::Entry& entry : entries)
+    fileEntries.push_back(PositionCache::toFileEntry(entry));
+  PositionCache::write(path, std::move(fileEntries), useSymmetry, game->getHashFingerprint());
+}
 
-    if (actionValue.value >= beta)
-      return actionValue;
+void MiniMaxSearch::setPositionCache(const std::shared_ptr<const PositionCache>& cache)
+{
+  //the keys of another game's positions would be looked up as if they were this game's
+  if (cache && cache->getGameFingerprint() != game->getHashFingerprint())
+    throw PositionCache::WrongGameException();
+  positionCache = cache;
+}
 
-    alpha = std::max(alpha, actionValue.value);
+void MiniMaxSearch::writeSearchTrace(std::ostream& out, SearchTrace::Format format) const
+{
+  //the threads of the last search are kept until the next one begins
+  std::vector<const SearchTrace*> searchTraces;
+  if constexpr (SEARCH_TRACE_ENABLED)
+  {
+    for (std::size_t i = 0; i < threads.size() && i < traces.size(); ++i)
+      searchTraces.push_back(traces[i].get());
   }
+  SearchTrace::write(out, format, searchTraces);
+}
 
-  return actionValue;
+void MiniMaxSearch::setTraceCapacity(std::size_t capacity)
+{
+  //the buffers are allocated again at the start of the next search
+  traceCapacity = capacity;
+  traces.clear();
 }
 
-ActionValue MiniMaxSearch::minValueWithPruning(const std::shared_ptr<State>& state, int alpha, int beta, int currentDepth)
+void MiniMaxSearch::beginSearch(const std::shared_ptr<State>& state, const std::vector<Options>& options, int threadCount)
 {
-  currentDepth++;
-  if (game->terminalState(state))
-    return {nullptr, game->getUtility(state, player)};
+  auto hasOption = [&options](Options option) { return std::find(options.begin(), options.end(), option) != options.end(); };
+  usePruning = hasOption(Options::USE_PRUNING);
+  useTranspositionTable = hasOption(Options::USE_TRANSPOSITION_TABLE);
+  useMoveOrdering = hasOption(Options::USE_MOVE_ORDERING);
+  usePrincipalVariationSearch = hasOption(Options::USE_PRINCIPAL_VARIATION_SEARCH);
+  useAspirationWindows = hasOption(Options::USE_ASPIRATION_WINDOWS);
+  useYoungBrothersWait = hasOption(Options::USE_YOUNG_BROTHERS_WAIT) && usePruning && threadCount > 1;
+  useInPlaceMoves = game->supportsInPlaceMoves();
+  useSearchArena = hasOption(Options::USE_SEARCH_ARENA);
+  useSymmetry = hasOption(Options::USE_SYMMETRY);
+  useBatchEvaluation = hasOption(Options::USE_BATCH_EVALUATION);
+  usePositionCache = positionCache && useTranspositionTable && positionCache->isSymmetric() == useSymmetry;
+  useMtdf = hasOption(Options::USE_MTDF) && usePruning;
 
-  if (depthLimit != -1)
-    if (currentDepth >= depthLimit)
-      return {nullptr, game->getEvaluationValue(state, player)};
-  
-  ActionValue actionValue;
-  actionValue.action = nullptr;
-  actionValue.value = INT_MAX;
+  if (useYoungBrothersWait && (!pool || pool->getThreadCount() != threadCount))
+    pool = std::make_unique<WorkStealingPool>(threadCount);
 
-  for (auto successor : game->successorStates(state))
+  player = game->getPlayerFromState(state);
   {
-    std::shared_ptr<State> state = successor.first;
-    ActionValue newActionValue = maxValueWithPruning(state, alpha, beta, currentDepth);
-    newActionValue.action = successor.second;
+    std::lock_guard<std::mutex> lock(bestSoFarMutex);
+    bestSoFar = {nullptr, 0};
+  }
+  nodeBudget = 0;
+  hasDeadline = false;
+  helpersStop.store(false, std::memory_order_relaxed);
+  sharedNodeCount.store(0, std::memory_order_relaxed);
+  //the table is kept from the searches of earlier moves - its values are for the player to move in each position so they still hold now that the root player may have changed
+  if (ageTranspositionTable)
+    transpositionTable->newGeneration();
 
-    if (newActionValue.value < actionValue.value)
-      actionValue = newActionValue;
-    
-    if (actionValue.value <= alpha)
-      return actionValue;
+  threads.clear();
+  threads.resize(threadCount);
+  for (int i = 0; i < threadCount; ++i)
+  {
+    threads[i].id = i;
+    threads[i].historyScores.assign(std::max(game->getActionIdCount(), 0), 0);
+  }
 
-    beta = std::max(beta, actionValue.value);
+  if (useSearchArena)
+  {
+    while (static_cast<int>(arenas.size()) < threadCount)
+      arenas.push_back(std::make_unique<SearchArena>());
+    for (int i = 0; i < threadCount; ++i)
+      threads[i].arena = arenas[i].get();
   }
 
-  return actionValue;
+  if constexpr (SEARCH_TRACE_ENABLED)
+  {
+    while (static_cast<int>(traces.size()) < threadCount)
+      traces.push_back(std::make_unique<SearchTrace>(traceCapacity));
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < threadCount; ++i)
+    {
+      traces[i]->clear();
+      threads[i].trace.begin(traces[i].get(), start, traceSamplePly, traceSampleInterval);
+    }
+  }
 }
 
-ActionValue MiniMaxSearch::maxValueWithTranspositionTable(const std::shared_ptr<State>& state, int currentDepth)
+ActionValue MiniMaxSearch::endSearch(const ActionValue& result)
 {
-  currentDepth++;
-  if (game->terminalState(state))
-    return {nullptr, game->getUtility(state, player)};
-  
-  if (depthLimit != -1)
-    if (currentDepth >= depthLimit)
-      return {nullptr, game->getEvaluationValue(state, player)};
-  
-  ActionValue actionValue;
-  actionValue.action = nullptr;
-  actionValue.value = INT_MIN;
+  if (result.action)
+  {
+    mtdfGuess = result.value;
+    mtdfGuessPlayer = player;
+  }
+
+  //everything built in the arenas was released as the search unwound, only the root's successors are still alive and they were never in an arena
+  for (std::unique_ptr<SearchArena>& arena : arenas)
+    arena->reset();
+
+  searchStats = SearchStats();
+  if constexpr (SEARCH_STATS_ENABLED)
+  {
+    for (const SearchThread& thread : threads)
+      searchStats.merge(thread.stats.getStats());
+    searchStats.transpositionProbes = getTranspositionTableProbes();
+    searchStats.transpositionHits = getTranspositionTableHits();
+    searchStats.lazySmp = threads.size() > 1 && !useYoungBrothersWait;
+  }
 
-  for (auto successor : game->successorStates(state))
+  return result;
+}
+
+void MiniMaxSearch::iterativeDeepening(SearchThread& thread, const std::shared_ptr<State>& state, const Limits& limits)
+{
+  //the main thread always completes its first iteration so that there is always a move to return
+  thread.abortEnabled = thread.id != 0;
+  //the first iteration is at depth 2 so a smaller depth limit is raised to it rather than leaving no iteration to run
+  int depthLimit = limits.depth == -1 ? -1 : std::max(limits.depth, 2);
+
+  //helpers are staggered by a ply so that they are not all searching the same depth at the same time
+  for (int depth = 2 + thread.id % 2; depthLimit == -1 || depth <= depthLimit; ++depth)
   {
-    std::shared_ptr<State> state = successor.first;
-    ActionValue newActionValue;
-    if (transpositionTable.find(state) != transpositionTable.end())
-      newActionValue.value = transpositionTable.at(state);
+    thread.depthLimitReached = false;
+    //with young brothers wait the iteration's nodes are spread over every thread, which are all idle between iterations
+    auto countNodes = [this, &thread]() { return useYoungBrothersWait ? getNodesVisited() : thread.nodesVisited; };
+    std::uint64_t iterationStartNodes = 0;
+    std::chrono::steady_clock::time_point iterationStart;
+    if constexpr (SEARCH_STATS_ENABLED)
+    {
+      iterationStartNodes = countNodes();
+      iterationStart = std::chrono::steady_clock::now();
+    }
+
+    ActionValue actionValue;
+    if (useMtdf)
+      actionValue = searchWithMtdf(thread, state, depth, thread.result.action ? thread.result.value : getMtdfGuess());
+    else if (useAspirationWindows && usePruning && thread.result.action)
+      actionValue = searchWithAspirationWindow(thread, state, depth, thread.result.value);
     else
+      actionValue = searchToDepth(thread, state, depth, -INFINITE_VALUE, INFINITE_VALUE);
+
+    if (thread.aborted)
+      break;
+
+    if constexpr (SEARCH_STATS_ENABLED)
+    {
+      if (thread.id == 0)
+        thread.stats.countIteration(depth, countNodes() - iterationStartNodes, std::chrono::duration<double>(std::chrono::steady_clock::now() - iterationStart).count());
+    }
+
+    thread.result = actionValue;
+    thread.completedDepth = depth;
+    if (thread.id == 0)
     {
-      newActionValue = minValueWithTranspositionTable(state, currentDepth);
-      transpositionTable[state] = newActionValue.value;
+      std::lock_guard<std::mutex> lock(bestSoFarMutex);
+      bestSoFar = actionValue;
     }
-    
-    newActionValue.action = successor.second;
+    thread.abortEnabled = true;
 
-    if (newActionValue.value > actionValue.value)
-      actionValue = newActionValue;
+    //no node was cut off by the depth limit so the whole tree has been searched
+    if (!thread.depthLimitReached)
+      break;
   }
+}
 
-  return actionValue;
+ActionValue MiniMaxSearch::searchToDepth(SearchThread& thread, const std::shared_ptr<State>& state, int depth, int alpha, int beta)
+{
+  thread.depthLimit = depth;
+  thread.rootAction = nullptr;
+
+  //an in place search changes the state it is given so works on its own copy
+  std::shared_ptr<State> searchState = useInPlaceMoves ? game->cloneState(state) : state;
+  int value = negamax(thread, searchState, alpha, beta, 0, 1);
+  return {thread.rootAction, value};
 }
 
-ActionValue MiniMaxSearch::minValueWithTranspositionTable(const std::shared_ptr<State>& state, int currentDepth)
+ActionValue MiniMaxSearch::searchWithAspirationWindow(SearchThread& thread, const std::shared_ptr<State>& state, int depth, int previousValue)
 {
-  currentDepth++;
-  if (game->terminalState(state))
-    return {nullptr, game->getUtility(state, player)};
+  //search a narrow window around the previous iteration's value and widen whichever side fails until the value lands inside it
+  long long delta = aspirationWindow;
+  int alpha = clampValue(static_cast<long long>(previousValue) - delta);
+  int beta = clampValue(static_cast<long long>(previousValue) + delta);
 
-  if (depthLimit != -1)
-    if (currentDepth >= depthLimit)
-      return {nullptr, game->getEvaluationValue(state, player)};
-  
-  ActionValue actionValue;
-  actionValue.action = nullptr;
-  actionValue.value = INT_MAX;
+  while (true)
+  {
+    ActionValue actionValue = searchToDepth(thread, state, depth, alpha, beta);
+    if (thread.aborted)
+      return actionValue;
+
+    delta *= 2;
+    if (actionValue.value <= alpha && alpha > -INFINITE_VALUE)
+      alpha = clampValue(static_cast<long long>(actionValue.value) - delta);
+    else if (actionValue.value >= beta && beta < INFINITE_VALUE)
+      beta = clampValue(static_cast<long long>(actionValue.value) + delta);
+    else
+      return actionValue;
+  }
+}
 
-  for (auto successor : game->successorStates(state))
+ActionValue MiniMaxSearch::searchWithMtdf(SearchThread& thread, const std::shared_ptr<State>& state, int depth, int firstGuess)
+{
+  //every null window search either fails high and proves a lower bound on the value or fails low and proves an upper bound,
+  //and the next one tests the bound it proved until the two meet - the transposition table keeps the bounds so each search revisits little of the last one's tree
+  int lowerBound = -INFINITE_VALUE;
+  int upperBound = INFINITE_VALUE;
+  int guess = firstGuess;
+  //a search that fails low has no best move, only one that fails high has found a move at least as good as its bound
+  ActionValue result = {nullptr, firstGuess};
+
+  while (lowerBound < upperBound)
   {
-    std::shared_ptr<State> state = successor.first;
-    ActionValue newActionValue;
-    if (transpositionTable.find(state) != transpositionTable.end())
-      newActionValue.value = transpositionTable.at(state);
+    int beta = std::max(guess, lowerBound + 1);
+    ActionValue actionValue = searchToDepth(thread, state, depth, beta - 1, beta);
+    if (thread.aborted)
+      return actionValue;
+
+    guess = actionValue.value;
+    if (guess >= beta)
+    {
+      lowerBound = guess;
+      result.action = actionValue.action;
+    }
     else
     {
-      newActionValue = maxValueWithTranspositionTable(state, currentDepth);
-      transpositionTable[state] = newActionValue.value;
+      upperBound = guess;
+      if (!result.action)
+        result.action = actionValue.action;
     }
-
-    newActionValue.action = successor.second;
-
-    if (newActionValue.value < actionValue.value)
-      actionValue = newActionValue;
   }
 
-  return actionValue;
+  result.value = guess;
+  return result;
 }
 
-ActionValue MiniMaxSearch::maxValueWithTranspositionTableAndPruning(const std::shared_ptr<State>& state, int alpha, int beta, int currentDepth)
+int MiniMaxSearch::getMtdfGuess() const
 {
-  currentDepth++;
+  //the last search may have been made for the other player
+  return (mtdfGuessPlayer == player) ? mtdfGuess : -mtdfGuess;
+}
+
+int MiniMaxSearch::negamax(SearchThread& thread, const std::shared_ptr<State>& state, int alpha, int beta, int ply, int colour)
+{
+  thread.nodesVisited++;
+  thread.stats.countNode(ply);
+  thread.trace.enter(ply, alpha, beta);
+  if (checkAbort(thread))
+    return thread.trace.exit(ply, 0, SearchTrace::Kind::ABORTED);
+
+  //the root's successors are kept as the result of the search so are built outside the arena
+  SearchArena::Scope arenaScope((ply > 0) ? thread.arena : nullptr);
+
   if (game->terminalState(state))
-    return {nullptr, game->getUtility(state, player)};
-  
-  if (depthLimit != -1)
-    if (currentDepth >= depthLimit)
-      return {nullptr, game->getEvaluationValue(state, player)};
-  
-  ActionValue actionValue;
-  actionValue.action = nullptr;
-  actionValue.value = INT_MIN;
+  {
+    thread.stats.countTerminalLeaf();
+    return thread.trace.exit(ply, colour * game->getUtility(state, player), SearchTrace::Kind::TERMINAL);
+  }
+
+  int remainingDepth = getRemainingDepth(thread, ply);
+  if (remainingDepth <= 0)
+  {
+    thread.stats.countEvaluatedLeaf();
+    thread.depthLimitReached = true;
+    return thread.trace.exit(ply, colour * game->getEvaluationValue(state, player), SearchTrace::Kind::LEAF);
+  }
 
-  for (auto successor : game->successorStates(state))
+  //a stored bound is only used when it is deep enough and proves a result for the current window
+  //at the root the entry only supplies the best move of the previous iteration
+  std::uint64_t key = 0;
+  int symmetry = 0;
+  int transpositionMove = -1;
+  if (useTranspositionTable)
   {
-    std::shared_ptr<State> state = successor.first;
-    ActionValue newActionValue;
-    if (transpositionTable.find(state) != transpositionTable.end())
-      newActionValue.value = transpositionTable.at(state);
+    key = useSymmetry ? state->getCanonicalHash(symmetry) : state->getHash();
+    TranspositionTable::Entry entry;
+    thread.transpositionProbes++;
+    if (transpositionTable->probe(key, entry) || (usePositionCache && positionCache->probe(key, entry)))
+    {
+      thread.transpositionHits++;
+      if (ply > 0 && entry.depth >= remainingDepth
+          && (entry.bound == TranspositionTable::Bound::EXACT
+            || (entry.bound == TranspositionTable::Bound::LOWER && entry.value >= beta)
+            || (entry.bound == TranspositionTable::Bound::UPPER && entry.value <= alpha)))
+      {
+        //an entry that is not valid to every depth was affected by the depth limit when it was stored
+        if (entry.depth < TranspositionTable::MAX_DEPTH)
+          thread.depthLimitReached = true;
+        return thread.trace.exit(ply, entry.value, SearchTrace::Kind::TRANSPOSITION);
+      }
+
+      if (entry.bestMove != TranspositionTable::NO_MOVE)
+        transpositionMove = entry.bestMove;
+    }
+  }
+
+  int originalAlpha = alpha;
+  int bestValue = -INFINITE_VALUE;
+  int bestMove = -1;
+  bool parentDepthLimitReached = thread.depthLimitReached;
+  thread.depthLimitReached = false;
+
+  Children children;
+  generateChildren(state, children, ply);
+
+  //with symmetry the table holds the best move as an action id in the canonical orientation so it is mapped back on to this state's children
+  if (useSymmetry && useMoveOrdering && transpositionMove != -1)
+    transpositionMove = findChild(children, state->mapActionId(transpositionMove, symmetry, false));
+
+  std::size_t moveOrderFrame = thread.moveOrders.size();
+  if (useMoveOrdering)
+    orderMoves(thread, state, children, transpositionMove, ply);
+
+  //one move from the depth limit every child is a leaf, so they can all be evaluated together
+  bool batchEvaluated = useBatchEvaluation && remainingDepth == 1 && !children.streamed;
+  if (batchEvaluated)
+    evaluateChildren(thread, state, children);
+
+  //helper threads start the root moves at different points to spread out the work
+  auto getMoveIndex = [&](std::size_t i)
+  {
+    std::size_t orderIndex = (ply == 0) ? (i + thread.id) % children.size() : i;
+    return useMoveOrdering ? thread.moveOrders[moveOrderFrame + orderIndex] : static_cast<int>(orderIndex);
+  };
+
+  for (std::size_t i = 0; hasChild(state, children, i); ++i)
+  {
+    int moveIndex = getMoveIndex(i);
+    int value;
+    if constexpr (SEARCH_TRACE_ENABLED)
+      thread.trace.setMove(ply + 1, getChildActionId(children, moveIndex), moveIndex);
+    if (batchEvaluated)
+    {
+      //what negamax would have done on visiting the child
+      thread.nodesVisited++;
+      thread.stats.countNode(ply + 1);
+      thread.stats.countEvaluatedLeaf();
+      thread.trace.enter(ply + 1, -beta, -alpha);
+      thread.depthLimitReached = true;
+      value = checkAbort(thread) ? 0 : colour * thread.leafValues[moveIndex];
+      thread.trace.exit(ply + 1, -value, thread.aborted ? SearchTrace::Kind::ABORTED : SearchTrace::Kind::LEAF);
+    }
+    else if (children.inPlace)
+    {
+      game->makeMove(state, children.moves[moveIndex]);
+      value = searchChild(thread, state, alpha, beta, ply, colour, i == 0);
+      game->unmakeMove(state, children.moves[moveIndex]);
+    }
     else
+      value = searchChild(thread, children.successors[moveIndex].first, alpha, beta, ply, colour, i == 0);
+
+    if (thread.aborted)
+      break;
+
+    if (value > bestValue)
     {
-      newActionValue = minValueWithTranspositionTableAndPruning(state, alpha, beta, currentDepth);
-      transpositionTable[state] = newActionValue.value;
+      bestValue = value;
+      bestMove = moveIndex;
+      if (ply == 0)
+        thread.rootAction = getChildAction(state, children, moveIndex);
     }
-    
-    newActionValue.action = successor.second;
 
-    if (newActionValue.value > actionValue.value)
-      actionValue = newActionValue;
+    if (usePruning)
+    {
+      if (bestValue >= beta)
+      {
+        thread.stats.countCutoff(i);
+        recordCutoff(thread, getChildActionId(children, moveIndex), ply);
+        break;
+      }
 
-    if (actionValue.value >= beta)
-      return actionValue;
+      alpha = std::max(alpha, bestValue);
+    }
+
+    //young brothers wait - once the eldest brother has set a bound the younger brothers are searched in parallel
+    if (i == 0 && canSplit(thread, ply) && hasChild(state, children, 1))
+    {
+      std::vector<int> youngerBrothers;
+      for (std::size_t j = 1; hasChild(state, children, j); ++j)
+        youngerBrothers.push_back(getMoveIndex(j));
+
+      SplitPoint splitPoint(thread.splitPoint, alpha, beta, bestValue, bestMove, thread.rootAction);
+      searchYoungerBrothers(thread, splitPoint, state, children, youngerBrothers, ply, colour);
+      if (thread.aborted)
+        break;
+
+      bestValue = splitPoint.bestValue;
+      bestMove = splitPoint.bestMove;
+      if (ply == 0)
+        thread.rootAction = splitPoint.bestAction;
+      if (splitPoint.depthLimitReached.load())
+        thread.depthLimitReached = true;
+      break;
+    }
   }
 
-  return actionValue;
+  thread.moveOrders.resize(moveOrderFrame);
+  if (thread.aborted)
+    return thread.trace.exit(ply, 0, SearchTrace::Kind::ABORTED);
+
+  //a subtree searched without reaching the depth limit has an exact result for any depth
+  if (useTranspositionTable)
+  {
+    int storedMove = bestMove;
+    if (useSymmetry && bestMove != -1)
+    {
+      int actionId = getChildActionId(children, bestMove);
+      storedMove = (actionId >= 0) ? state->mapActionId(actionId, symmetry, true) : -1;
+    }
+
+    TranspositionTable::StoreResult storeResult = transpositionTable->store(key, bestValue, thread.depthLimitReached ? remainingDepth : TranspositionTable::MAX_DEPTH, getBound(bestValue, originalAlpha, beta), storedMove);
+    thread.stats.countTranspositionStore(storeResult);
+  }
+
+  thread.depthLimitReached = thread.depthLimitReached || parentDepthLimitReached;
+  return thread.trace.exit(ply, bestValue, (usePruning && bestValue >= beta) ? SearchTrace::Kind::CUTOFF : SearchTrace::Kind::SEARCHED);
 }
 
-ActionValue MiniMaxSearch::minValueWithTranspositionTableAndPruning(const std::shared_ptr<State>& state, int alpha, int beta, int currentDepth)
+int MiniMaxSearch::searchChild(SearchThread& thread, const std::shared_ptr<State>& state, int alpha, int beta, int ply, int colour, bool firstChild)
 {
-  currentDepth++;
-  if (game->terminalState(state))
-    return {nullptr, game->getUtility(state, player)};
+  //principal variation search - after the first move each move is tested against the best so far with a null window and only re-searched if it is better
+  if (firstChild || !usePrincipalVariationSearch || !usePruning)
+    return -negamax(thread, state, -beta, -alpha, ply + 1, -colour);
 
-  if (depthLimit != -1)
-    if (currentDepth >= depthLimit)
-      return {nullptr, game->getEvaluationValue(state, player)};
-  
-  ActionValue actionValue;
-  actionValue.action = nullptr;
-  actionValue.value = INT_MAX;
+  int value = -negamax(thread, state, -alpha - 1, -alpha, ply + 1, -colour);
+  if (value > alpha && value < beta && !thread.aborted)
+    value = -negamax(thread, state, -beta, -alpha, ply + 1, -colour);
+  return value;
+}
 
-  for (auto successor : game->successorStates(state))
+bool MiniMaxSearch::canSplit(const SearchThread& thread, int ply) const
+{
+  if (!useYoungBrothersWait)
+    return false;
+
+  //without a depth limit the height of the subtree is unknown so only the nodes nearest the root are split
+  if (thread.depthLimit == -1)
+    return ply < MAX_UNLIMITED_SPLIT_PLY;
+  return getRemainingDepth(thread, ply) >= MIN_SPLIT_DEPTH;
+}
+
+void MiniMaxSearch::searchYoungerBrothers(SearchThread& thread, SplitPoint& splitPoint, const std::shared_ptr<State>& state, const Children& children, const std::vector<int>& youngerBrothers, int ply, int colour)
+{
+  WorkStealingPool::TaskGroup group;
+  for (std::size_t i = 0; i < youngerBrothers.size(); ++i)
   {
-    std::shared_ptr<State> state = successor.first;
-    ActionValue newActionValue;
-    if (transpositionTable.find(state) != transpositionTable.end())
-      newActionValue.value = transpositionTable.at(state);
-    else
+    //the eldest brother was move 0
+    int moveIndex = youngerBrothers[i];
+    int moveNumber = static_cast<int>(i) + 1;
+    pool->submit(group, [this, &splitPoint, &state, &children, moveIndex, moveNumber, ply, colour, depthLimit = thread.depthLimit, abortEnabled = thread.abortEnabled]()
     {
-      newActionValue = maxValueWithTranspositionTableAndPruning(state, alpha, beta, currentDepth);
-      transpositionTable[state] = newActionValue.value;
+      searchYoungerBrother(threads[pool->getCurrentWorker()], splitPoint, state, children, moveIndex, moveNumber, ply, colour, depthLimit, abortEnabled);
+    });
+  }
+
+  //rather than block, the waiting thread runs queued tasks until its own have all finished
+  pool->wait(group);
+
+  //a brother that was stopped by anything other than a cutoff at this node leaves its result unknown
+  if (splitPoint.incomplete.load() && !splitPoint.cutoff.load())
+    thread.aborted = true;
+}
+
+void MiniMaxSearch::searchYoungerBrother(SearchThread& thread, SplitPoint& splitPoint, const std::shared_ptr<State>& state, const Children& children, int moveIndex, int moveNumber, int ply, int colour, int depthLimit, bool abortEnabled)
+{
+  if (splitPoint.isCancelled())
+  {
+    splitPoint.incomplete.store(true);
+    return;
+  }
+
+  //the task may have been picked up by a thread in the middle of another search, which carries on once the task is done
+  int interruptedDepthLimit = thread.depthLimit;
+  bool interruptedAborted = thread.aborted;
+  bool interruptedAbortEnabled = thread.abortEnabled;
+  bool interruptedDepthLimitReached = thread.depthLimitReached;
+  const SplitPoint* interruptedSplitPoint = thread.splitPoint;
+  auto interruptedTrace = thread.trace.suspend();
+
+  thread.depthLimit = depthLimit;
+  thread.aborted = false;
+  thread.abortEnabled = abortEnabled;
+  thread.depthLimitReached = false;
+  thread.splitPoint = &splitPoint;
+
+  //the node's state is left alone by the thread waiting on it, so an in place search of a brother starts from a copy of it
+  std::shared_ptr<State> childState;
+  if (children.inPlace)
+  {
+    childState = game->cloneState(state);
+    game->makeMove(childState, children.moves[moveIndex]);
+  }
+  else
+    childState = children.successors[moveIndex].first;
+
+  if constexpr (SEARCH_TRACE_ENABLED)
+    thread.trace.setMove(ply + 1, getChildActionId(children, moveIndex), moveIndex);
+  int value = searchChild(thread, childState, splitPoint.alpha.load(), splitPoint.beta, ply, colour, false);
+
+  if (thread.aborted)
+    splitPoint.incomplete.store(true);
+  else
+  {
+    std::lock_guard<std::mutex> lock(splitPoint.mutex);
+    if (thread.depthLimitReached)
+      splitPoint.depthLimitReached.store(true);
+
+    if (!splitPoint.cutoff.load())
+    {
+      if (value > splitPoint.bestValue)
+      {
+        splitPoint.bestValue = value;
+        splitPoint.bestMove = moveIndex;
+        if (ply == 0)
+        {
+          SearchArena::Scope heapScope(nullptr);
+          splitPoint.bestAction = getChildAction(state, children, moveIndex);
+        }
+      }
+
+      if (splitPoint.bestValue >= splitPoint.beta)
+      {
+        splitPoint.cutoff.store(true);
+        thread.stats.countCutoff(moveNumber);
+        recordCutoff(thread, getChildActionId(children, moveIndex), ply);
+      }
+      else
+        splitPoint.alpha.store(std::max(splitPoint.alpha.load(), splitPoint.bestValue));
     }
+  }
+
+  thread.depthLimit = interruptedDepthLimit;
+  thread.aborted = interruptedAborted;
+  thread.abortEnabled = interruptedAbortEnabled;
+  thread.depthLimitReached = interruptedDepthLimitReached;
+  thread.splitPoint = interruptedSplitPoint;
+  thread.trace.resume(interruptedTrace);
+}
 
-    newActionValue.action = successor.second;
+bool MiniMaxSearch::checkAbort(SearchThread& thread)
+{
+  //node counts are published to the other threads every 1024 nodes, which is also how often the clock is read
+  bool checkpoint = (thread.nodesVisited & 1023) == 0;
+  if (checkpoint)
+    sharedNodeCount.fetch_add(1024, std::memory_order_relaxed);
 
-    if (newActionValue.value < actionValue.value)
-      actionValue = newActionValue;
+  if (thread.abortEnabled && !thread.aborted)
+    thread.aborted = stopRequested.load(std::memory_order_relaxed)
+      || helpersStop.load(std::memory_order_relaxed)
+      || (nodeBudget != 0 && sharedNodeCount.load(std::memory_order_relaxed) + (thread.nodesVisited & 1023) >= nodeBudget)
+      || (hasDeadline && checkpoint && std::chrono::steady_clock::now() >= deadline);
 
-    if (actionValue.value <= alpha)
-      return actionValue;
+  //a cutoff at any split point above this node makes the rest of its search pointless
+  if (!thread.aborted && thread.splitPoint != nullptr && thread.splitPoint->isCancelled())
+    thread.aborted = true;
+
+  return thread.aborted;
+}
+
+ActionValue MiniMaxSearch::performSearch(const std::vector<Options>& options)
+{
+  return performSearch(game->getState(), options, -1);
+}
 
-    beta = std::max(beta, actionValue.value);
+ActionValue MiniMaxSearch::performSearch(const std::vector<Options>& options, int depth)
+{
+  return performSearch(game->getState(), options, depth);
+}
+
+ActionValue MiniMaxSearch::performSearch(int depth)
+{
+  std::vector<Options> options;
+  return performSearch(game->getState(), options, depth);
+}
+
+int MiniMaxSearch::getRemainingDepth(const SearchThread& thread, int ply)
+{
+  //the depth limit counts the root as the first level
+  return (thread.depthLimit == -1) ? TranspositionTable::MAX_DEPTH : thread.depthLimit - ply - 1;
+}
+
+int MiniMaxSearch::clampValue(long long value)
+{
+  return static_cast<int>(std::clamp<long long>(value, -INFINITE_VALUE, INFINITE_VALUE));
+}
+
+void MiniMaxSearch::generateChildren(const std::shared_ptr<State>& state, Children& children, int ply) const
+{
+  //a pruning search with no move ordering to do searches the children in the order they are produced, so only needs each one when it gets to it
+  //the root is always built up front as helper threads start at different root moves
+  children.inPlace = useInPlaceMoves;
+  children.streamed = !useInPlaceMoves && usePruning && !useMoveOrdering && ply > 0;
+  if (children.inPlace)
+    children.moveCount = game->generateMoves(state, children.moves);
+  else if (!children.streamed)
+    children.successors = game->successorStates(state);
+}
+
+void MiniMaxSearch::evaluateChildren(SearchThread& thread, const std::shared_ptr<State>& state, const Children& children) const
+{
+  thread.leafValues.resize(children.size());
+  if (children.inPlace)
+  {
+    game->evaluateMoveBatch(state, std::span<const Move>(children.moves.data(), children.moveCount), player, thread.leafValues);
+    return;
   }
 
-  return actionValue;
+  for (const std::pair<std::shared_ptr<State>, std::shared_ptr<Action>>& successor : children.successors)
+    thread.leafStates.push_back(successor.first);
+  game->evaluateBatch(thread.leafStates, player, thread.leafValues);
+  //the states may live in the thread's arena, which must not be reset while anything still holds them
+  thread.leafStates.clear();
+}
+
+bool MiniMaxSearch::hasChild(const std::shared_ptr<State>& state, Children& children, std::size_t index) const
+{
+  while (children.streamed && !children.exhausted && children.successors.size() <= index)
+  {
+    std::pair<std::shared_ptr<State>, std::shared_ptr<Action>> successor;
+    if (game->nextSuccessor(state, children.cursor, successor))
+      children.successors.push_back(std::move(successor));
+    else
+      children.exhausted = true;
+  }
+
+  return index < children.size();
+}
+
+std::shared_ptr<Action> MiniMaxSearch::getChildAction(const std::shared_ptr<State>& state, const Children& children, int index) const
+{
+  return children.inPlace ? game->getMoveAction(state, children.moves[index]) : children.successors[index].second;
+}
+
+int MiniMaxSearch::getChildActionId(const Children& children, int index) const
+{
+  return children.inPlace ? game->getMoveId(children.moves[index]) : game->getActionId(children.successors[index].second);
+}
+
+int MiniMaxSearch::getChildOrderingScore(const std::shared_ptr<State>& state, const Children& children, int index) const
+{
+  return children.inPlace ? game->getMoveScore(state, children.moves[index]) : game->getMoveOrderingScore(state, children.successors[index].second);
 }
+
+int MiniMaxSearch::findChild(const Children& children, int actionId) const
+{
+  for (std::size_t i = 0; i < children.size(); ++i)
+  {
+    if (getChildActionId(children, i) == actionId)
+      return i;
+  }
+  return -1;
+}
+
+void MiniMaxSearch::orderMoves(SearchThread& thread, const std::shared_ptr<State>& state, const Children& children, int transpositionMove, int ply) const
+{
+  //the transposition table move goes first, then the killer moves for this ply, then the rest by history score with the game's static score breaking ties
+  const std::array<int, 2>& killers = (ply < static_cast<int>(thread.killerMoves.size())) ? thread.killerMoves[ply] : NO_KILLERS;
+
+  std::vector<ScoredMove>& scoredMoves = thread.scoredMoves;
+  scoredMoves.clear();
+  for (std::size_t i = 0; i < children.size(); ++i)
+  {
+    int actionId = getChildActionId(children, i);
+
+    ScoredMove scoredMove = {static_cast<int>(i), 0, 0, getChildOrderingScore(state, children, i)};
+    if (static_cast<int>(i) == transpositionMove)
+      scoredMove.priority = 3;
+    else if (actionId >= 0 && actionId == killers[0])
+      scoredMove.priority = 2;
+    else if (actionId >= 0 && actionId == killers[1])
+      scoredMove.priority = 1;
+
+    if (actionId >= 0 && actionId < static_cast<int>(thread.historyScores.size()))
+      scoredMove.historyScore = thread.historyScores[actionId];
+
+    scoredMoves.push_back(scoredMove);
+  }
+
+  std::stable_sort(scoredMoves.begin(), scoredMoves.end(), [](const ScoredMove& lhs, const ScoredMove& rhs)
+  {
+    if (lhs.priority != rhs.priority)
+      return lhs.priority > rhs.priority;
+    if (lhs.historyScore != rhs.historyScore)
+      return lhs.historyScore > rhs.historyScore;
+    return lhs.staticScore > rhs.staticScore;
+  });
+
+  //pushed on to the stack of move orders, which the node pops again when it returns
+  for (const ScoredMove& scoredMove : scoredMoves)
+    thread.moveOrders.push_back(scoredMove.index);
+}
+
+void MiniMaxSearch::recordCutoff(SearchThread& thread, int actionId, int ply)
+{
+  if (!useMoveOrdering || actionId < 0)
+    return;
+
+  if (ply >= static_cast<int>(thread.killerMoves.size()))
+    thread.killerMoves.resize(ply + 1, NO_KILLERS);
+
+  std::array<int, 2>& killers = thread.killerMoves[ply];
+  if (killers[0] != actionId)
+  {
+    killers[1] = killers[0];
+    killers[0] = actionId;
+  }
+
+  //cutoffs further from the leaves prune more so are weighted more heavily
+  if (actionId < static_cast<int>(thread.historyScores.size()))
+  {
+    int depthBonus = std::min(getRemainingDepth(thread, ply), 32);
+    thread.historyScores[actionId] += depthBonus * depthBonus;
+  }
+}
+
+TranspositionTable::Bound MiniMaxSearch::getBound(int value, int alpha, int beta)
+{
+  if (value <= alpha)
+    return TranspositionTable::Bound::UPPER;
+  if (value >= beta)
+    return TranspositionTable::Bound::LOWER;
+  return TranspositionTable::Bound::EXACT;
+}
\ No newline at end of file
@@ -1,13 +1,28 @@
 #ifndef MINI_MAX_WITH_PRUNING_H_
 #define MINI_MAX_WITH_PRUNING_H_
 
+#include <array>
 #include <vector>
 #include <utility>
 #include <memory>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <future>
+#include <algorithm>
+#include <string>
+#include <span>
+#include <limits.h>
 #include <iostream>
-#include <unordered_map>
 
 #include "Player.hpp"
+#include "TranspositionTable.hpp"
+#include "WorkStealingPool.hpp"
+#include "SearchArena.hpp"
+#include "SearchStats.hpp"
+#include "SearchTrace.hpp"
+#include "PositionCache.hpp"
 
 struct State
 {
@@ -20,11 +35,17 @@ struct State
   virtual ~State() = default;
   virtual std::size_t getHash() const { throw NoEqualityAndHashImplementationException(); return 0; }
   virtual bool operator==(const std::shared_ptr<State>& rhs) const { throw State::NoEqualityAndHashImplementationException(); return false; }
+
+  //Optional hooks for MiniMaxSearch::Options::USE_SYMMETRY - getCanonicalHash is the same for every state equivalent to this one under the game's symmetries,
+  //and reports which symmetry takes this state to the canonical one so that mapActionId can carry an action id (see SearchableGame::getActionId) to the canonical orientation and back
+  virtual std::size_t getCanonicalHash(int& symmetry) const { symmetry = 0; return getHash(); }
+  virtual int mapActionId(int actionId, int symmetry, bool toCanonical) const { return actionId; }
 };
 
 struct StateSharedPointerEquality 
 {
-  bool operator()(const std::shared_ptr<State>& lhs, const std::shared_ptr<State>& rhs) const { return *lhs == rhs; }
+  //Hashes are expected to be cheap (see ZobristKeys) so compare them before falling back to full state equality
+  bool operator()(const std::shared_ptr<State>& lhs, const std::shared_ptr<State>& rhs) const { return lhs->getHash() == rhs->getHash() && *lhs == rhs; }
 };
 
 struct StateSharedPointerHash
@@ -32,11 +53,50 @@ struct StateSharedPointerHash
   std::size_t operator()(const std::shared_ptr<State>& state) const { return state->getHash(); }
 };
 
+//Table of random keys, one per (square, piece) pair, for Zobrist hashing a game state
+//A state hash is the XOR of the keys of every occupied square, so placing or removing a piece updates it with a single XOR
+template <std::size_t Squares, std::size_t Pieces>
+class ZobristKeys
+{
+public:
+  constexpr ZobristKeys(std::uint64_t seed = 0x9E3779B97F4A7C15ull) : keys()
+  {
+    //splitmix64 - deterministic so hashes are reproducible between runs
+    for (std::uint64_t& key : keys)
+    {
+      seed += 0x9E3779B97F4A7C15ull;
+      std::uint64_t z = seed;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      key = z ^ (z >> 31);
+    }
+  }
+
+  constexpr std::uint64_t get(std::size_t square, std::size_t piece) const { return keys[square * Pieces + piece]; }
+
+  //Differs between tables of different sizes or seeds, so it tells apart hashes made with different tables
+  constexpr std::uint64_t getFingerprint() const
+  {
+    std::uint64_t fingerprint = 0xCBF29CE484222325ull ^ (Squares << 8) ^ Pieces;
+    for (std::uint64_t key : keys)
+      fingerprint = (fingerprint ^ key) * 0x100000001B3ull;
+    return fingerprint;
+  }
+
+private:
+  std::array<std::uint64_t, Squares * Pieces> keys;
+};
+
 struct Action
 {
   virtual ~Action() = default;
 };
 
+//Compact encoding of an action for the in place move interface of SearchableGame - what it means is up to the game
+typedef std::uint32_t Move;
+
+typedef std::vector<std::pair<std::shared_ptr<State>, std::shared_ptr<Action>>> Successors;
+
 struct ActionValue
 {
   std::shared_ptr<Action> action;
@@ -53,28 +113,139 @@ public:
     virtual const char* what() const throw() override { return "No evaluation function overridded in the instance of SearchableGame - In order to set a depth to search to, an implementation for getEvaluationFunction() must be provided in the SearchableGame"; }
   };
 
+  class NoInPlaceMovesImplementationException : public std::exception
+  {
+  public:
+    virtual const char* what() const throw() override { return "No in place move functions overridden in the instance of SearchableGame - supportsInPlaceMoves() must only return true when cloneState(), generateMoves(), makeMove(), unmakeMove() and getMoveAction() are all provided"; }
+  };
+
+  static constexpr std::size_t MAX_MOVES = 256;
+  typedef std::array<Move, MAX_MOVES> MoveBuffer;
+
+  //How far a walk through the successors of a state has got - a game resumes the walk from position, which starts at 0
+  struct SuccessorCursor
+  {
+    std::uint64_t position = 0;
+    Successors buffered;
+  };
+
+  //Implementations must be safe to call concurrently from several threads to be searched by more than one thread
   virtual std::vector<std::pair<std::shared_ptr<State>, std::shared_ptr<Action>>> successorStates(const std::shared_ptr<State>& state) const = 0;
   virtual bool terminalState(const std::shared_ptr<State>& state) const = 0;
   virtual int getUtility(const std::shared_ptr<State>& state, const Player& player) const = 0;
   virtual int getEvaluationValue(const std::shared_ptr<State>& state, const Player& player) const { throw NoEvaluationFunctionImplementationException(); }
   virtual Player getPlayerFromState(const std::shared_ptr<State>& state) const = 0;
   virtual std::shared_ptr<State> getState() const = 0;
+
+  //Produces the successors of a state one at a time in the order successorStates() lists them, returning false once there are no more
+  //The pruning search takes them from here so that a cutoff saves building the rest - the default builds them all on the first call
+  virtual bool nextSuccessor(const std::shared_ptr<State>& state, SuccessorCursor& cursor, std::pair<std::shared_ptr<State>, std::shared_ptr<Action>>& successor) const
+  {
+    if (cursor.position == 0)
+      cursor.buffered = successorStates(state);
+    if (cursor.position >= cursor.buffered.size())
+      return false;
+    successor = cursor.buffered[cursor.position++];
+    return true;
+  }
+
+  //Optional hooks used by MiniMaxSearch::Options::USE_MOVE_ORDERING
+  //getActionId maps an action to an id in [0, getActionIdCount()) that is the same for the same move in any state, or -1 if there is no such id
+  virtual int getActionId(const std::shared_ptr<Action>& action) const { return -1; }
+  virtual int getActionIdCount() const { return 0; }
+  //Higher scoring actions are searched earlier when nothing else is known about them
+  virtual int getMoveOrderingScore(const std::shared_ptr<State>& state, const std::shared_ptr<Action>& action) const { return 0; }
+
+  //Optional in place interface - when supportsInPlaceMoves() is true MiniMaxSearch searches its own clone of a state with makeMove and unmakeMove instead of calling successorStates
+  //generateMoves writes the legal moves of a state to the buffer, in the same order each time for the same state, and returns how many there are
+  virtual bool supportsInPlaceMoves() const { return false; }
+  virtual std::shared_ptr<State> cloneState(const std::shared_ptr<State>& state) const { throw NoInPlaceMovesImplementationException(); }
+  virtual std::size_t generateMoves(const std::shared_ptr<State>& state, MoveBuffer& moves) const { throw NoInPlaceMovesImplementationException(); }
+  virtual void makeMove(const std::shared_ptr<State>& state, Move move) const { throw NoInPlaceMovesImplementationException(); }
+  virtual void unmakeMove(const std::shared_ptr<State>& state, Move move) const { throw NoInPlaceMovesImplementationException(); }
+  //The action a move stands for in the state it is made from - only needed for the moves at the root of a search
+  virtual std::shared_ptr<Action> getMoveAction(const std::shared_ptr<State>& state, Move move) const { throw NoInPlaceMovesImplementationException(); }
+  //Move equivalents of getActionId and getMoveOrderingScore
+  virtual int getMoveId(Move move) const { return -1; }
+  virtual int getMoveScore(const std::shared_ptr<State>& state, Move move) const { return 0; }
+  //Optional batch forms of leaf evaluation for MiniMaxSearch::Options::USE_BATCH_EVALUATION, which hands over all the children of a node one move from the depth limit at once
+  //Each value is what getUtility gives for a state that ends the game and getEvaluationValue gives otherwise
+  //evaluateBatch takes the states themselves, evaluateMoveBatch the states the moves lead to from state, which it must leave as it found it
+  virtual void evaluateBatch(std::span<const std::shared_ptr<State>> states, const Player& player, std::span<int> values) const
+  {
+    for (std::size_t i = 0; i < states.size(); ++i)
+      values[i] = terminalState(states[i]) ? getUtility(states[i], player) : getEvaluationValue(states[i], player);
+  }
+
+  virtual void evaluateMoveBatch(const std::shared_ptr<State>& state, std::span<const Move> moves, const Player& player, std::span<int> values) const
+  {
+    for (std::size_t i = 0; i < moves.size(); ++i)
+    {
+      makeMove(state, moves[i]);
+      values[i] = terminalState(state) ? getUtility(state, player) : getEvaluationValue(state, player);
+      unmakeMove(state, moves[i]);
+    }
+  }
+
+  //Optional hook for position cache files - identifies the game and the way it hashes its states, so that a file written for one game is refused by another
+  //0 means the game does not say and only matches files from other games which do not say
+  virtual std::uint64_t getHashFingerprint() const { return 0; }
+
+  //Optional hook for MctsSearch::RolloutPolicy::GAME - picks the index of the move in the buffer to play next in a rollout, given a random number to choose with
+  virtual std::size_t chooseRolloutMove(const std::shared_ptr<State>& state, const MoveBuffer& moves, std::size_t moveCount, std::uint64_t random) const { return random % moveCount; }
+
   virtual void printState(const std::shared_ptr<State>& state) const { std::cout << "State print undefined" << std::endl; }
   virtual void printAction(const std::shared_ptr<Action>& action) const { std::cout << "Action print undefined" << std::endl; }
 
   virtual ~SearchableGame() = default;
 };
 
+//Searches a SearchableGame with a single negamax core - getUtility and getEvaluationValue must be zero sum, so that a state's value for one player is the negation of its value for the other
 class MiniMaxSearch
 {
 public:
+  static constexpr int INFINITE_VALUE = INT_MAX;
+
+  //Move ordering, principal variation search and aspiration windows only take effect along with USE_PRUNING
+  //and aspiration windows only apply to the iterative deepening searches
+  //MTD(f) replaces each full window search with a series of null window searches that close in on the value from a first guess,
+  //relying on the transposition table to keep the bounds each one proves - it needs USE_PRUNING, is meant to be used with USE_TRANSPOSITION_TABLE and overrides aspiration windows
+  //Young brothers wait splits the pruning search over the threads of a multithreaded search instead of running lazy SMP
+  //Symmetry keys the transposition table by State::getCanonicalHash so equivalent positions share an entry
+  //Batch evaluation evaluates all the children of a node one move from the depth limit with one call to SearchableGame::evaluateBatch or evaluateMoveBatch,
+  //and counts every child it evaluates as having reached the depth limit even if it ended the game
+  //The search arena gives each search thread an arena for the game's makeSearchShared states and actions, which is reset once the search returns
+  //so the game must not keep hold of anything it built during the search
   enum class Options
   {
     USE_TRANSPOSITION_TABLE,
-    USE_PRUNING
+    USE_PRUNING,
+    USE_MOVE_ORDERING,
+    USE_PRINCIPAL_VARIATION_SEARCH,
+    USE_ASPIRATION_WINDOWS,
+    USE_YOUNG_BROTHERS_WAIT,
+    USE_SEARCH_ARENA,
+    USE_SYMMETRY,
+    USE_BATCH_EVALUATION,
+    USE_MTDF
+  };
+
+  //Budget for an iterative deepening search - a zero time or node budget means no limit and a depth of -1 searches until the tree is exhausted
+  //Iterations start at depth 2, so a depth below 2 is searched to depth 2
+  struct Limits
+  {
+    int depth = -1;
+    std::chrono::milliseconds time = std::chrono::milliseconds::zero();
+    std::uint64_t nodes = 0;
   };
 
-  MiniMaxSearch(const std::shared_ptr<SearchableGame>& game) : game(game), player(game->getPlayerFromState(game->getState())), depthLimit(-1), transpositionTable() {}
+  MiniMaxSearch(const std::shared_ptr<const SearchableGame>& game, std::size_t transpositionTableSizeMB = TranspositionTable::DEFAULT_SIZE_MB)
+    : game(game), player(game->getPlayerFromState(game->getState())), transpositionTable(std::make_shared<TranspositionTable>(transpositionTableSizeMB)), ageTranspositionTable(true), threads(1),
+      traceCapacity(SearchTrace::DEFAULT_CAPACITY), traceSamplePly(0), traceSampleInterval(1),
+      bestSoFar({nullptr, 0}), ponderThreadCount(1), nodeBudget(0), hasDeadline(false), deadline(), stopRequested(false), helpersStop(false), sharedNodeCount(0),
+      usePruning(false), useTranspositionTable(false), useMoveOrdering(false), usePrincipalVariationSearch(false), useAspirationWindows(false),
+      useYoungBrothersWait(false), useInPlaceMoves(false), useSearchArena(false), useSymmetry(false), useBatchEvaluation(false), usePositionCache(false), useMtdf(false), aspirationWindow(1) {}
+  ~MiniMaxSearch();
   ActionValue performSearch();
   ActionValue performSearch(const std::shared_ptr<State>& state);
   ActionValue performSearch(const std::shared_ptr<State>& state, int depth);
@@ -84,19 +255,257 @@ public:
   ActionValue performSearch(const std::vector<Options>& options, int depth);
   ActionValue performSearch(int depth);
 
+  //Iterative deepening searches which return the best action of the last completed iteration once a budget runs out or stop() is called
+  ActionValue performSearch(const std::shared_ptr<State>& state, const std::vector<Options>& options, const Limits& limits);
+  ActionValue performSearch(const std::shared_ptr<State>& state, const std::vector<Options>& options, std::chrono::milliseconds timeBudget);
+  ActionValue performSearch(const std::vector<Options>& options, const Limits& limits);
+  //Lazy SMP - threadCount threads search the same root sharing the transposition table, the game must be safe to use from all of them at once
+  //With USE_YOUNG_BROTHERS_WAIT the threads instead share out the subtrees of a single search
+  ActionValue performSearch(const std::shared_ptr<State>& state, const std::vector<Options>& options, const Limits& limits, int threadCount);
+
+  //Searches a batch of states at once, each by a single threaded search on one of threadCount threads, and returns their results in the same order
+  //Each thread has its own search so one MiniMaxSearch answers the whole batch, and the game must be safe to use from all of the threads at once
+  //With shareTranspositionTable the searches share this search's table, so positions that come up in more than one of them are only searched once
+  //getNodesVisited afterwards is the total over the batch
+  std::vector<ActionValue> searchBatch(const std::vector<std::shared_ptr<State>>& states);
+  std::vector<ActionValue> searchBatch(const std::vector<std::shared_ptr<State>>& states, const std::vector<Options>& options, int depth);
+  std::vector<ActionValue> searchBatch(const std::vector<std::shared_ptr<State>>& states, const std::vector<Options>& options, const Limits& limits, int threadCount, bool shareTranspositionTable);
+
+  //Safe to call from another thread - cancels the iterative deepening search in progress
+  void stop() { stopRequested.store(true, std::memory_order_relaxed); }
+
+  //An iterative deepening search running on a thread of its own - destroying the handle stops the search and waits for it
+  class SearchHandle
+  {
+  public:
+    SearchHandle(MiniMaxSearch& search, std::future<ActionValue> result) : search(&search), result(std::move(result)) {}
+    SearchHandle(SearchHandle&&) = default;
+    SearchHandle& operator=(SearchHandle&&) = default;
+    ~SearchHandle();
+
+    void stop() { search->stop(); }
+    //The result of the deepest iteration completed so far, with a null action before the first has completed
+    ActionValue bestSoFar() const { return search->getBestSoFar(); }
+    bool isFinished() const;
+    //Waits for the search to finish by itself, giving up after timeout - returns whether it finished
+    bool waitFor(std::chrono::milliseconds timeout) const;
+    //Waits for the search to finish and returns its result - can only be called once
+    ActionValue get();
+
+  private:
+    MiniMaxSearch* search;
+    std::future<ActionValue> result;
+  };
+
+  //Starts an iterative deepening search on another thread and returns straight away
+  //Only one search can run at a time, so nothing else may be searched with this MiniMaxSearch until the handle's search has finished
+  SearchHandle startSearch(const std::shared_ptr<State>& state, const std::vector<Options>& options, const Limits& limits, int threadCount = 1);
+  ActionValue getBestSoFar() const;
+
+  //Pondering searches during the opponent's turn - startPondering is given the state the opponent is to move from just after this side's search of the previous move
+  //When the transposition table predicts the opponent's reply it searches the position after that reply, otherwise it searches the opponent's position, which covers every reply
+  //finishPondering is given the state once the opponent has moved - on a ponder hit the search already under way is given whatever is left of the limits' time,
+  //counted from when pondering started, so the answer is immediate if the opponent took longer than that, otherwise the state is searched with the transposition table the ponder search filled
+  void startPondering(const std::shared_ptr<State>& state, const std::vector<Options>& options, const Limits& limits, int threadCount = 1);
+  ActionValue finishPondering(const std::shared_ptr<State>& state);
+  bool isPondering() const { return ponderSearch != nullptr; }
+
+  std::uint64_t getNodesVisited() const;
+  //Lookups made in the transposition table by the last search and how many of them found an entry for the position
+  std::uint64_t getTranspositionTableProbes() const;
+  std::uint64_t getTranspositionTableHits() const;
+  //With USE_SEARCH_ARENA, the most memory the search threads' arenas have had in use at once and the blocks they have reserved, over every search so far
+  std::size_t getSearchArenaPeakBytes() const;
+  std::size_t getSearchArenaBytesReserved() const;
+  //Filled in by the last search when built with MINIMAX_SEARCH_STATS, otherwise always empty
+  const SearchStats& getSearchStats() const { return searchStats; }
+  //Writes the nodes the last search entered and left when built with MINIMAX_SEARCH_TRACE, otherwise an empty trace
+  void writeSearchTrace(std::ostream& out, SearchTrace::Format format) const;
+  //Each search thread keeps the newest capacity events it recorded, two for every node
+  void setTraceCapacity(std::size_t capacity);
+  //Records only every interval'th subtree rooted at ply, to bound the cost of tracing a long search - by default every node is recorded
+  //The time spent in the subtrees left out counts as time spent in their parents
+  void setTraceSampling(int ply, unsigned int interval) { traceSamplePly = ply; traceSampleInterval = std::max(interval, 1u); }
+  void setTranspositionTableSize(std::size_t sizeMB) { transpositionTable->resize(sizeMB); }
+  //The transposition table is kept from search to search so that each move's search starts with what the searches of earlier moves found
+  //newGame empties it, and should be called before searching a position that is not from the same game
+  void newGame() { transpositionTable->clear(); mtdfGuess = 0; }
+  //Positions missing from the transposition table are looked up in the cache, so a search can start with what the searches of an earlier process found
+  //A cache is only used by searches with the transposition table that key it the same way, with or without USE_SYMMETRY
+  //Throws PositionCache::WrongGameException when the cache was written for a game with a different SearchableGame::getHashFingerprint
+  void setPositionCache(const std::shared_ptr<const PositionCache>& cache);
+  //Writes everything in the transposition table to a position cache file, keyed the way the last search keyed the table
+  void savePositionCache(const std::string& path) const;
+  //Half width of the first aspiration window around the previous iteration's value - should be on the scale of the game's values
+  void setAspirationWindow(int halfWidth) { aspirationWindow = std::max(halfWidth, 1); }
+
 private:
+  static constexpr std::array<int, 2> NO_KILLERS = {-1, -1};
+  //Nodes closer to the leaves than this are not worth splitting between threads
+  static constexpr int MIN_SPLIT_DEPTH = 3;
+  static constexpr int MAX_UNLIMITED_SPLIT_PLY = 4;
+
+  //The children of a node - built up front by successorStates, taken one at a time from nextSuccessor as the search needs them,
+  //or, when the game supports it, made in place from a buffer of moves
+  struct Children
+  {
+    bool inPlace = false;
+    bool streamed = false;
+    bool exhausted = false;
+    Successors successors;
+    SearchableGame::SuccessorCursor cursor;
+    SearchableGame::MoveBuffer moves;
+    std::size_t moveCount = 0;
+
+    //for streamed children only the ones produced so far
+    std::size_t size() const { return inPlace ? moveCount : successors.size(); }
+  };
+
+  struct ScoredMove
+  {
+    int index;
+    int priority;
+    int historyScore;
+    int staticScore;
+  };
+
+  //A node whose younger siblings are being searched in parallel - a cutoff in one of them cancels the rest, and the nodes below them
+  struct SplitPoint
+  {
+    const SplitPoint* parent;
+    int beta;
+    std::atomic<int> alpha;
+    std::atomic<bool> cutoff;
+    std::atomic<bool> incomplete;
+    std::atomic<bool> depthLimitReached;
+    std::mutex mutex;
+    int bestValue;
+    int bestMove;
+    std::shared_ptr<Action> bestAction;
+
+    SplitPoint(const SplitPoint* parent, int alpha, int beta, int bestValue, int bestMove, const std::shared_ptr<Action>& bestAction)
+      : parent(parent), beta(beta), alpha(alpha), cutoff(false), incomplete(false), depthLimitReached(false), bestValue(bestValue), bestMove(bestMove), bestAction(bestAction) {}
+
+    bool isCancelled() const
+    {
+      for (const SplitPoint* splitPoint = this; splitPoint != nullptr; splitPoint = splitPoint->parent)
+      {
+        if (splitPoint->cutoff.load(std::memory_order_relaxed))
+          return true;
+      }
+      return false;
+    }
+  };
+
+  //Everything one search thread modifies while searching - threads searching together only share the transposition table
+  struct alignas(64) SearchThread
+  {
+    int id = 0;
+    int depthLimit = -1;
+    std::uint64_t nodesVisited = 0;
+    std::uint64_t transpositionProbes = 0;
+    std::uint64_t transpositionHits = 0;
+    bool aborted = false;
+    bool abortEnabled = false;
+    bool depthLimitReached = false;
+    std::shared_ptr<Action> rootAction;
+    std::vector<std::array<int, 2>> killerMoves;
+    std::vector<int> historyScores;
+    ActionValue result = {nullptr, 0};
+    int completedDepth = 0;
+    const SplitPoint* splitPoint = nullptr;
+    SearchArena* arena = nullptr;
+    //scratch space reused from node to node - moveOrders is a stack holding the move order of every node on the current path
+    std::vector<int> moveOrders;
+    std::vector<ScoredMove> scoredMoves;
+    //values of the children of the node being batch evaluated - leaves have no children so there is only ever one such node at a time
+    std::vector<int> leafValues;
+    std::vector<std::shared_ptr<State>> leafStates;
+    [[no_unique_address]] SearchStatsCounter<SEARCH_STATS_ENABLED> stats;
+    [[no_unique_address]] SearchTraceRecorder<SEARCH_TRACE_ENABLED> trace;
+  };
+
   std::shared_ptr<const SearchableGame> game;
   Player player;
-  int depthLimit;
-  std::unordered_map<std::shared_ptr<State>, int, StateSharedPointerHash, StateSharedPointerEquality> transpositionTable;
-  ActionValue maxValue(const std::shared_ptr<State>& state, int currentDepth);
-  ActionValue minValue(const std::shared_ptr<State>& state, int currentDepth);
-  ActionValue maxValueWithPruning(const std::shared_ptr<State>& state, int alpha, int beta, int currentDepth);
-  ActionValue minValueWithPruning(const std::shared_ptr<State>& state, int alpha, int beta, int currentDepth);
-  ActionValue maxValueWithTranspositionTable(const std::shared_ptr<State>& state, int currentDepth);
-  ActionValue minValueWithTranspositionTable(const std::shared_ptr<State>& state, int currentDepth);
-  ActionValue maxValueWithTranspositionTableAndPruning(const std::shared_ptr<State>& state, int alpha, int beta, int currentDepth);
-  ActionValue minValueWithTranspositionTableAndPruning(const std::shared_ptr<State>& state, int alpha, int beta, int currentDepth);
+  //shared with the searches of a batch when they share a table
+  std::shared_ptr<TranspositionTable> transpositionTable;
+  bool ageTranspositionTable;
+  std::shared_ptr<const PositionCache> positionCache;
+  std::vector<SearchThread> threads;
+  std::unique_ptr<WorkStealingPool> pool;
+  //kept from search to search so that their blocks are reused
+  std::vector<std::unique_ptr<SearchArena>> arenas;
+  //the search each of the pool's threads uses for its share of a batch, kept from batch to batch
+  std::vector<std::unique_ptr<MiniMaxSearch>> batchSearches;
+  SearchStats searchStats;
+  //one for each search thread, kept from search to search so that they are only allocated once
+  std::vector<std::unique_ptr<SearchTrace>> traces;
+  std::size_t traceCapacity;
+  int traceSamplePly;
+  unsigned int traceSampleInterval;
+
+  mutable std::mutex bestSoFarMutex;
+  ActionValue bestSoFar;
+
+  std::unique_ptr<SearchHandle> ponderSearch;
+  //null when pondering all of the opponent's replies
+  std::shared_ptr<State> ponderState;
+  std::vector<Options> ponderOptions;
+  Limits ponderLimits;
+  int ponderThreadCount;
+  std::chrono::steady_clock::time_point ponderStart;
+
+  std::uint64_t nodeBudget;
+  bool hasDeadline;
+  std::chrono::steady_clock::time_point deadline;
+  std::atomic<bool> stopRequested;
+  std::atomic<bool> helpersStop;
+  std::atomic<std::uint64_t> sharedNodeCount;
+
+  bool usePruning;
+  bool useTranspositionTable;
+  bool useMoveOrdering;
+  bool usePrincipalVariationSearch;
+  bool useAspirationWindows;
+  bool useYoungBrothersWait;
+  bool useInPlaceMoves;
+  bool useSearchArena;
+  bool useSymmetry;
+  bool useBatchEvaluation;
+  bool usePositionCache;
+  bool useMtdf;
+  int aspirationWindow;
+  //the value of the last search, the first guess of an MTD(f) search's first iteration
+  int mtdfGuess = 0;
+  Player mtdfGuessPlayer = Player::Player1;
+
+  ActionValue searchWithLimits(const std::shared_ptr<State>& state, const std::vector<Options>& options, const Limits& limits, int threadCount);
+  std::shared_ptr<State> predictReply(const std::shared_ptr<State>& state) const;
+  void beginSearch(const std::shared_ptr<State>& state, const std::vector<Options>& options, int threadCount);
+  ActionValue endSearch(const ActionValue& result);
+  void iterativeDeepening(SearchThread& thread, const std::shared_ptr<State>& state, const Limits& limits);
+  ActionValue searchToDepth(SearchThread& thread, const std::shared_ptr<State>& state, int depth, int alpha, int beta);
+  ActionValue searchWithAspirationWindow(SearchThread& thread, const std::shared_ptr<State>& state, int depth, int previousValue);
+  ActionValue searchWithMtdf(SearchThread& thread, const std::shared_ptr<State>& state, int depth, int firstGuess);
+  int getMtdfGuess() const;
+  int negamax(SearchThread& thread, const std::shared_ptr<State>& state, int alpha, int beta, int ply, int colour);
+  int searchChild(SearchThread& thread, const std::shared_ptr<State>& state, int alpha, int beta, int ply, int colour, bool firstChild);
+  bool canSplit(const SearchThread& thread, int ply) const;
+  void searchYoungerBrothers(SearchThread& thread, SplitPoint& splitPoint, const std::shared_ptr<State>& state, const Children& children, const std::vector<int>& youngerBrothers, int ply, int colour);
+  void searchYoungerBrother(SearchThread& thread, SplitPoint& splitPoint, const std::shared_ptr<State>& state, const Children& children, int moveIndex, int moveNumber, int ply, int colour, int depthLimit, bool abortEnabled);
+  bool checkAbort(SearchThread& thread);
+  void generateChildren(const std::shared_ptr<State>& state, Children& children, int ply) const;
+  void evaluateChildren(SearchThread& thread, const std::shared_ptr<State>& state, const Children& children) const;
+  bool hasChild(const std::shared_ptr<State>& state, Children& children, std::size_t index) const;
+  std::shared_ptr<Action> getChildAction(const std::shared_ptr<State>& state, const Children& children, int index) const;
+  int getChildActionId(const Children& children, int index) const;
+  int getChildOrderingScore(const std::shared_ptr<State>& state, const Children& children, int index) const;
+  int findChild(const Children& children, int actionId) const;
+  void orderMoves(SearchThread& thread, const std::shared_ptr<State>& state, const Children& children, int transpositionMove, int ply) const;
+  void recordCutoff(SearchThread& thread, int actionId, int ply);
+  static int getRemainingDepth(const SearchThread& thread, int ply);
+  static int clampValue(long long value);
+  static TranspositionTable::Bound getBound(int value, int alpha, int beta);
 };
 
 #endif
\ No newline at end of file
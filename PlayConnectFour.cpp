@@ -0,0 +1,120 @@
+#include "PlayConnectFour.hpp"
+
+#include <map>
+#include <string>
+#include <thread>
+
+PlayConnectFour::PlayConnectFour(const PlayPolicy playPolicy, std::chrono::milliseconds thinkingTime, Engine engine)
+  : connectFourGame(std::make_shared<ConnectFour>()), searchableGame(connectFourGame), search(searchableGame, 64), mctsSearch(searchableGame),
+    playPolicy(playPolicy), thinkingTime(thinkingTime), engine(engine)
+{
+  mctsSearch.setRolloutPolicy(MctsSearch::RolloutPolicy::GAME);
+  //evaluations are on the scale of the line scores rather than single points
+  search.setAspirationWindow(16);
+}
+
+void PlayConnectFour::play()
+{
+  char choice = 'y';
+  if (playPolicy == PlayPolicy::SINGLEPLAYER)
+  {
+    std::cout << "Would you like to go first (y,n)? " << std::flush;
+    std::cin >> choice;
+  }
+
+  std::map<int, std::string> assignedPlayers;
+  if (choice == 'y')
+  {
+    assignedPlayers[1] = "PLAYER";
+    if (playPolicy == PlayPolicy::SINGLEPLAYER)
+      assignedPlayers[2] = "COMPUTER";
+    else
+      assignedPlayers[2] = "PLAYER";
+  }
+  else
+  {
+    assignedPlayers[2] = "PLAYER";
+    if (playPolicy == PlayPolicy::SINGLEPLAYER)
+      assignedPlayers[1] = "COMPUTER";
+    else
+      assignedPlayers[1] = "PLAYER";
+  }
+
+  std::cout << *connectFourGame << std::endl;
+  for (int i = 0; i < ConnectFourBoard::CELLS; ++i)
+  {
+    if (assignedPlayers.at(i % 2 + 1) == "PLAYER")
+      playerMove();
+    else
+      computerMove();
+
+    if (connectFourGame->checkEndOfGame())
+      break;
+  }
+
+  if (connectFourGame->checkWinner(Player::Player1))
+    std::cout << "Player 1 wins!" << std::endl;
+  else if (connectFourGame->checkWinner(Player::Player2))
+    std::cout << "Player 2 wins" << std::endl;
+  else
+    std::cout << "Draw!" << std::endl;
+}
+
+void PlayConnectFour::playerMove()
+{
+  int column;
+  bool validMove = false;
+  while (!validMove)
+  {
+    validMove = true;
+    std::cout << "Enter column number: " << std::endl;
+    std::cin >> column;
+    try
+    {
+      connectFourGame->makeMove(column);
+    }
+    catch (ConnectFour::ConnectFourInvalidMoveException& e)
+    {
+      std::cout << e.what() << std::endl;
+      validMove = false;
+    }
+  }
+
+  std::cout << *connectFourGame << std::endl;
+}
+
+void PlayConnectFour::computerMove()
+{
+  //the tree is far too big to search to the end so the computer deepens iteratively until its thinking time runs out
+  std::vector<MiniMaxSearch::Options> options;
+  options.push_back(MiniMaxSearch::Options::USE_TRANSPOSITION_TABLE);
+  options.push_back(MiniMaxSearch::Options::USE_PRUNING);
+  options.push_back(MiniMaxSearch::Options::USE_MOVE_ORDERING);
+  options.push_back(MiniMaxSearch::Options::USE_PRINCIPAL_VARIATION_SEARCH);
+  options.push_back(MiniMaxSearch::Options::USE_ASPIRATION_WINDOWS);
+
+  MiniMaxSearch::Limits limits;
+  limits.time = thinkingTime;
+  int threadCount = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+
+  auto start = std::chrono::high_resolution_clock::now();
+  ActionValue actionValue;
+  if (engine == Engine::MCTS)
+    actionValue = mctsSearch.performSearch(connectFourGame->getState(), thinkingTime, threadCount);
+  else
+    actionValue = search.isPondering() ? search.finishPondering(connectFourGame->getState()) : search.performSearch(connectFourGame->getState(), options, limits, threadCount);
+  std::shared_ptr<ConnectFourAction> computerMove = std::dynamic_pointer_cast<ConnectFourAction>(actionValue.action);
+  auto finish = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> elapsed = finish - start;
+  if (engine == Engine::MCTS)
+    std::cout << "Elapsed time: " << elapsed.count() << " s, playouts: " << mctsSearch.getIterations() << std::endl;
+  else
+    std::cout << "Elapsed time: " << elapsed.count() << " s, nodes searched: " << search.getNodesVisited() << std::endl;
+  std::cout << "Computer moved to: " << computerMove->column << std::endl;
+  connectFourGame->makeMove(computerMove->column);
+  std::cout << *connectFourGame << std::endl;
+
+  //think about the reply while the player decides on it
+  if (engine == Engine::MINIMAX && playPolicy == PlayPolicy::SINGLEPLAYER && !connectFourGame->checkEndOfGame())
+    search.startPondering(connectFourGame->getState(), options, limits, threadCount);
+}
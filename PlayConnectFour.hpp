@@ -0,0 +1,44 @@
+#ifndef PLAY_CONNECT_FOUR_H_
+#define PLAY_CONNECT_FOUR_H_
+
+#include "ConnectFour.hpp"
+#include "MctsSearch.hpp"
+
+#include <chrono>
+
+class PlayConnectFour
+{
+public:
+
+  enum class PlayPolicy
+  {
+    SINGLEPLAYER,
+    MULTIPLAYER
+  };
+
+  //Which search chooses the computer's moves
+  enum class Engine
+  {
+    MINIMAX,
+    MCTS
+  };
+
+  PlayConnectFour(const PlayPolicy playPolicy, std::chrono::milliseconds thinkingTime = std::chrono::milliseconds(1000), Engine engine = Engine::MINIMAX);
+  void play();
+
+private:
+  std::shared_ptr<ConnectFour> connectFourGame;
+  std::shared_ptr<SearchableGame> searchableGame;
+  MiniMaxSearch search;
+  MctsSearch mctsSearch;
+  const PlayPolicy playPolicy;
+  const std::chrono::milliseconds thinkingTime;
+  const Engine engine;
+
+  void playerMove();
+  void computerMove();
+
+};
+
+
+#endif
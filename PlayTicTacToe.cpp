@@ -1,10 +1,12 @@
 #include "PlayTicTacToe.hpp"
 
 #include <chrono>
+#include <map>
+#include <string>
 
-PlayTicTacToe::PlayTicTacToe(const PlayPolicy playPolicy)
-  : playPolicy(playPolicy), ticTacGame(std::make_shared<TicTacToe>()), searchableGame(ticTacGame),
-    search(searchableGame) {}
+PlayTicTacToe::PlayTicTacToe(const PlayPolicy playPolicy, Engine engine)
+  : ticTacGame(std::make_shared<TicTacToe>()), searchableGame(ticTacGame), search(searchableGame),
+    playPolicy(playPolicy), engine(engine) {}
 
 void PlayTicTacToe::play()
 {
@@ -91,11 +93,20 @@ void PlayTicTacToe::computerMove()
   options.push_back(MiniMaxSearch::Options::USE_TRANSPOSITION_TABLE);
   options.push_back(MiniMaxSearch::Options::USE_PRUNING);
   auto start = std::chrono::high_resolution_clock::now();
-  std::shared_ptr<TicTacToeAction> computerMove = std::dynamic_pointer_cast<TicTacToeAction>(search.performSearch(options).action);
+  ActionValue actionValue;
+  if (engine == Engine::ORACLE)
+    actionValue = ticTacGame->getOracleMove(ticTacGame->getState());
+  else
+    actionValue = search.isPondering() ? search.finishPondering(ticTacGame->getState()) : search.performSearch(ticTacGame->getState(), options, MiniMaxSearch::Limits());
+  std::shared_ptr<TicTacToeAction> computerMove = std::dynamic_pointer_cast<TicTacToeAction>(actionValue.action);
   auto finish = std::chrono::high_resolution_clock::now();
   std::chrono::duration<double> elapsed = finish - start;
   std::cout << "Elapsed time: " << elapsed.count() << " s" << std::endl;
   std::cout << "Computer moved to: " << computerMove->cell << std::endl;
   ticTacGame->makeMove(computerMove->cell);
   std::cout << *ticTacGame << std::endl;
+
+  //think about the reply while the player decides on it
+  if (engine == Engine::MINIMAX && playPolicy == PlayPolicy::SINGLEPLAYER && !ticTacGame->checkEndOfGame())
+    search.startPondering(ticTacGame->getState(), options, MiniMaxSearch::Limits());
 }
\ No newline at end of file
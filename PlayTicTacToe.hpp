@@ -13,7 +13,15 @@ public:
     MULTIPLAYER
   };
 
-  PlayTicTacToe(const PlayPolicy playPolicy);
+  //Which chooses the computer's moves - the oracle looks them up in the solution TicTacToe builds during compilation
+  //and the minimax search ponders during the player's turns
+  enum class Engine
+  {
+    ORACLE,
+    MINIMAX
+  };
+
+  PlayTicTacToe(const PlayPolicy playPolicy, Engine engine = Engine::ORACLE);
   void play();
 
 private:
@@ -21,6 +29,7 @@ private:
   std::shared_ptr<SearchableGame> searchableGame;
   MiniMaxSearch search;
   const PlayPolicy playPolicy;
+  const Engine engine;
 
   void playerMove();
   void computerMove();
@@ -0,0 +1,86 @@
+#include "PositionCache.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+PositionCache::PositionCache(const std::string& path) : mapping(nullptr), mappingSize(0), header(nullptr), entries(nullptr)
+{
+  int file = open(path.c_str(), O_RDONLY);
+  if (file < 0)
+    throw PositionCacheFileException();
+
+  struct stat fileStatus;
+  if (fstat(file, &fileStatus) != 0 || static_cast<std::size_t>(fileStatus.st_size) < sizeof(Header))
+  {
+    close(file);
+    throw InvalidPositionCacheFileException();
+  }
+
+  //the mapping keeps the file open by itself
+  mappingSize = fileStatus.st_size;
+  mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, file, 0);
+  close(file);
+  if (mapping == MAP_FAILED)
+  {
+    mapping = nullptr;
+    throw PositionCacheFileException();
+  }
+
+  header = static_cast<const Header*>(mapping);
+  entries = reinterpret_cast<const FileEntry*>(static_cast<const char*>(mapping) + sizeof(Header));
+  if (header->magic != MAGIC || header->version != FORMAT_VERSION || (mappingSize - sizeof(Header)) / sizeof(FileEntry) != header->entryCount
+      || (mappingSize - sizeof(Header)) % sizeof(FileEntry) != 0)
+  {
+    munmap(mapping, mappingSize);
+    throw InvalidPositionCacheFileException();
+  }
+}
+
+PositionCache::~PositionCache()
+{
+  munmap(mapping, mappingSize);
+}
+
+bool PositionCache::probe(std::uint64_t key, TranspositionTable::Entry& entry) const
+{
+  const FileEntry* end = entries + header->entryCount;
+  const FileEntry* found = std::lower_bound(entries, end, key, [](const FileEntry& fileEntry, std::uint64_t key) { return fileEntry.key < key; });
+  if (found == end || found->key != key)
+    return false;
+
+  entry = {found->key, found->value, found->depth, found->bound, found->bestMove, 0};
+  return true;
+}
+
+void PositionCache::write(const std::string& path, std::vector<FileEntry> entries, bool symmetric, std::uint64_t gameFingerprint)
+{
+  //sorting the best entry for each position first lets unique keep it
+  std::sort(entries.begin(), entries.end(), [](const FileEntry& lhs, const FileEntry& rhs)
+  {
+    if (lhs.key != rhs.key)
+      return lhs.key < rhs.key;
+    if (lhs.depth != rhs.depth)
+      return lhs.depth > rhs.depth;
+    return lhs.bound == TranspositionTable::Bound::EXACT && rhs.bound != TranspositionTable::Bound::EXACT;
+  });
+  entries.erase(std::unique(entries.begin(), entries.end(), [](const FileEntry& lhs, const FileEntry& rhs) { return lhs.key == rhs.key; }), entries.end());
+
+  Header header = {MAGIC, FORMAT_VERSION, symmetric ? SYMMETRIC : 0u, entries.size(), gameFingerprint};
+  std::string temporaryPath = path + ".tmp";
+  std::FILE* file = std::fopen(temporaryPath.c_str(), "wb");
+  if (file == nullptr)
+    throw PositionCacheFileException();
+
+  bool written = std::fwrite(&header, sizeof(Header), 1, file) == 1
+    && std::fwrite(entries.data(), sizeof(FileEntry), entries.size(), file) == entries.size();
+  if (std::fclose(file) != 0 || !written || std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+  {
+    std::remove(temporaryPath.c_str());
+    throw PositionCacheFileException();
+  }
+}
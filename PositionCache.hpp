@@ -0,0 +1,95 @@
+#ifndef POSITION_CACHE_H_
+#define POSITION_CACHE_H_
+
+#include <vector>
+#include <string>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+
+#include "TranspositionTable.hpp"
+
+//Read only file of searched positions that MiniMaxSearch falls back on when its transposition table has no entry for a position,
+//so that a new process starts with what earlier processes found
+//The file is mapped into memory rather than read - opening it costs nothing however big it is, and every process with the same file open shares one copy of it
+//A file is a Header followed by its entries sorted by key, so a lookup is a binary search straight over the mapped file
+//Files are in the byte order of the machine that wrote them and hold entries for one game, which the header records,
+//keyed the way the writing search keyed its transposition table
+class PositionCache
+{
+public:
+  class PositionCacheFileException : public std::exception
+  {
+  public:
+    virtual const char* what() const throw() override { return "Could not open, map or write the position cache file"; }
+  };
+
+  class WrongGameException : public std::exception
+  {
+  public:
+    virtual const char* what() const throw() override { return "The position cache file was written for a different game, or for one that hashes its states differently"; }
+  };
+
+  class InvalidPositionCacheFileException : public std::exception
+  {
+  public:
+    virtual const char* what() const throw() override { return "Not a position cache file - either it is damaged, or it was written by a different version or on a machine with a different byte order"; }
+  };
+
+  static constexpr std::uint64_t MAGIC = 0x45484341434D4D50ull;
+  //increase whenever the layout of Header or FileEntry changes
+  static constexpr std::uint32_t FORMAT_VERSION = 2;
+
+  enum Flags : std::uint32_t
+  {
+    //keys are State::getCanonicalHash and best moves canonical action ids, as stored by a search with USE_SYMMETRY
+    SYMMETRIC = 1
+  };
+
+  struct Header
+  {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint64_t entryCount;
+    //SearchableGame::getHashFingerprint of the game the entries are for
+    std::uint64_t gameFingerprint;
+  };
+
+  //A transposition table entry without its generation
+  struct FileEntry
+  {
+    std::uint64_t key;
+    std::int32_t value;
+    std::int16_t depth;
+    TranspositionTable::Bound bound;
+    std::uint8_t bestMove;
+  };
+
+  static_assert(sizeof(Header) == 32 && sizeof(FileEntry) == 16, "The layout of a position cache file has changed - increase FORMAT_VERSION");
+
+  explicit PositionCache(const std::string& path);
+  ~PositionCache();
+
+  PositionCache(const PositionCache&) = delete;
+  PositionCache& operator=(const PositionCache&) = delete;
+
+  //Safe to call from any number of threads
+  bool probe(std::uint64_t key, TranspositionTable::Entry& entry) const;
+  bool isSymmetric() const { return header->flags & SYMMETRIC; }
+  std::uint64_t getGameFingerprint() const { return header->gameFingerprint; }
+  std::span<const FileEntry> getEntries() const { return {entries, static_cast<std::size_t>(header->entryCount)}; }
+
+  //Writes a file holding one entry per position - where there are several for the same position the deepest is kept, and of those an exact one
+  //The file is written under a temporary name and renamed over path, so processes which have the old file open carry on using it undisturbed
+  static void write(const std::string& path, std::vector<FileEntry> entries, bool symmetric, std::uint64_t gameFingerprint);
+  static FileEntry toFileEntry(const TranspositionTable::Entry& entry) { return {entry.key, entry.value, entry.depth, entry.bound, entry.bestMove}; }
+
+private:
+  void* mapping;
+  std::size_t mappingSize;
+  const Header* header;
+  const FileEntry* entries;
+};
+
+#endif
@@ -0,0 +1,105 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdlib>
+
+#include "PositionCache.hpp"
+
+//Offline maintenance of position cache files
+//  minimax_cache info <file>...                          prints what each file holds
+//  minimax_cache merge <output> <input>... [--min-depth n]  writes one file with the best entry for each position in the inputs,
+//                                                          dropping entries searched less than n plies deep
+//Merging a single input into itself compacts it in place
+namespace
+{
+  int printUsage(const char* program)
+  {
+    std::cerr << "Usage: " << program << " info <file>..." << std::endl
+              << "       " << program << " merge <output> <input>... [--min-depth n]" << std::endl;
+    return 1;
+  }
+
+  void printInfo(const std::string& path, const PositionCache& cache)
+  {
+    std::uint64_t exact = 0;
+    std::uint64_t toTheEnd = 0;
+    for (const PositionCache::FileEntry& entry : cache.getEntries())
+    {
+      if (entry.bound == TranspositionTable::Bound::EXACT)
+        exact++;
+      if (entry.depth == TranspositionTable::MAX_DEPTH)
+        toTheEnd++;
+    }
+
+    std::cout << path << ": " << cache.getEntries().size() << " positions, " << exact << " exact, " << toTheEnd << " searched to the end of the game"
+              << (cache.isSymmetric() ? ", symmetric keys" : "") << ", game " << std::hex << cache.getGameFingerprint() << std::dec << std::endl;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc < 3)
+    return printUsage(argv[0]);
+
+  std::string command = argv[1];
+  try
+  {
+    if (command == "info")
+    {
+      for (int i = 2; i < argc; ++i)
+        printInfo(argv[i], PositionCache(argv[i]));
+      return 0;
+    }
+
+    if (command != "merge" || argc < 4)
+      return printUsage(argv[0]);
+
+    std::string outputPath = argv[2];
+    int minDepth = 0;
+    std::vector<std::unique_ptr<PositionCache>> inputs;
+    for (int i = 3; i < argc; ++i)
+    {
+      std::string argument = argv[i];
+      if (argument == "--min-depth" && i + 1 < argc)
+        minDepth = std::atoi(argv[++i]);
+      else
+        inputs.push_back(std::make_unique<PositionCache>(argument));
+    }
+    if (inputs.empty())
+      return printUsage(argv[0]);
+
+    //keys from searches with and without symmetry, or from different games, are hashes of different things so cannot be mixed
+    std::vector<PositionCache::FileEntry> entries;
+    for (const std::unique_ptr<PositionCache>& input : inputs)
+    {
+      if (input->isSymmetric() != inputs[0]->isSymmetric())
+      {
+        std::cerr << "Cannot merge caches written with and without symmetry" << std::endl;
+        return 1;
+      }
+      if (input->getGameFingerprint() != inputs[0]->getGameFingerprint())
+      {
+        std::cerr << "Cannot merge caches written for different games" << std::endl;
+        return 1;
+      }
+      for (const PositionCache::FileEntry& entry : input->getEntries())
+      {
+        if (entry.depth >= minDepth)
+          entries.push_back(entry);
+      }
+    }
+
+    std::uint64_t inputEntries = entries.size();
+    PositionCache::write(outputPath, std::move(entries), inputs[0]->isSymmetric(), inputs[0]->getGameFingerprint());
+    std::cout << "merged " << inputEntries << " entries from " << inputs.size() << " files" << std::endl;
+    printInfo(outputPath, PositionCache(outputPath));
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include "SearchArena.hpp"
+
+#include <algorithm>
+
+namespace
+{
+  thread_local SearchArena* currentArena = nullptr;
+}
+
+SearchArena::SearchArena(std::size_t blockSize)
+  : blockSize(std::max(blockSize, MAX_ARENA_ALLOCATION)), currentBlock(0), blockOffset(0), freeLists(), bytesInUse(0), peakBytesInUse(0) {}
+
+void* SearchArena::allocate(std::size_t size)
+{
+  if (size > MAX_ARENA_ALLOCATION)
+    return ::operator new(size);
+
+  std::size_t sizeClass = getSizeClass(size);
+  std::size_t roundedSize = (sizeClass + 1) * GRANULARITY;
+  bytesInUse += roundedSize;
+  peakBytesInUse = std::max(peakBytesInUse, bytesInUse);
+
+  //reuse memory freed earlier in the search before taking more from the blocks
+  if (FreeBlock* freeBlock = freeLists[sizeClass])
+  {
+    freeLists[sizeClass] = freeBlock->next;
+    return freeBlock;
+  }
+
+  if (currentBlock < blocks.size() && blockOffset + roundedSize > blockSize)
+  {
+    currentBlock++;
+    blockOffset = 0;
+  }
+
+  //blocks are kept by reset() so a new one is only needed when the search goes further than any before it
+  if (currentBlock == blocks.size())
+    blocks.emplace_back(new std::byte[blockSize]);
+
+  void* memory = blocks[currentBlock].get() + blockOffset;
+  blockOffset += roundedSize;
+  return memory;
+}
+
+void SearchArena::deallocate(void* memory, std::size_t size)
+{
+  if (size > MAX_ARENA_ALLOCATION)
+  {
+    ::operator delete(memory);
+    return;
+  }
+
+  std::size_t sizeClass = getSizeClass(size);
+  bytesInUse -= (sizeClass + 1) * GRANULARITY;
+
+  FreeBlock* freeBlock = static_cast<FreeBlock*>(memory);
+  freeBlock->next = freeLists[sizeClass];
+  freeLists[sizeClass] = freeBlock;
+}
+
+void SearchArena::reset()
+{
+  currentBlock = 0;
+  blockOffset = 0;
+  freeLists.fill(nullptr);
+  bytesInUse = 0;
+}
+
+SearchArena* SearchArena::getCurrent()
+{
+  return currentArena;
+}
+
+SearchArena::Scope::Scope(SearchArena* arena) : previous(currentArena)
+{
+  currentArena = arena;
+}
+
+SearchArena::Scope::~Scope()
+{
+  currentArena = previous;
+}
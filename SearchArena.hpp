@@ -0,0 +1,114 @@
+#ifndef SEARCH_ARENA_H_
+#define SEARCH_ARENA_H_
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+//Memory for the states and actions built during a search - allocation bumps a pointer through large blocks, freed memory is kept on a free list for its size,
+//and reset() hands every block back in constant time once nothing allocated from the arena is left alive
+//An arena belongs to a single search thread so it takes no locks
+class SearchArena
+{
+public:
+  static constexpr std::size_t GRANULARITY = alignof(std::max_align_t);
+  //Larger allocations are passed on to the global heap
+  static constexpr std::size_t MAX_ARENA_ALLOCATION = 512;
+  static constexpr std::size_t DEFAULT_BLOCK_SIZE = 1 << 20;
+
+  SearchArena(std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+  SearchArena(const SearchArena&) = delete;
+  SearchArena& operator=(const SearchArena&) = delete;
+
+  void* allocate(std::size_t size);
+  void deallocate(void* memory, std::size_t size);
+  void reset();
+
+  std::size_t getBytesReserved() const { return blocks.size() * blockSize; }
+  std::size_t getBytesInUse() const { return bytesInUse; }
+  std::size_t getPeakBytesInUse() const { return peakBytesInUse; }
+
+  //The arena makeSearchShared allocates from on the calling thread, or nullptr for the global heap
+  static SearchArena* getCurrent();
+
+  //Makes an arena (or the global heap for nullptr) current on this thread for as long as it is in scope
+  class Scope
+  {
+  public:
+    Scope(SearchArena* arena);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    SearchArena* previous;
+  };
+
+private:
+  struct FreeBlock
+  {
+    FreeBlock* next;
+  };
+
+  static constexpr std::size_t SIZE_CLASSES = MAX_ARENA_ALLOCATION / GRANULARITY;
+
+  std::size_t blockSize;
+  std::vector<std::unique_ptr<std::byte[]>> blocks;
+  std::size_t currentBlock;
+  std::size_t blockOffset;
+  std::array<FreeBlock*, SIZE_CLASSES> freeLists;
+  std::size_t bytesInUse;
+  std::size_t peakBytesInUse;
+
+  static std::size_t getSizeClass(std::size_t size) { return (size + GRANULARITY - 1) / GRANULARITY - 1; }
+};
+
+//Standard allocator over a SearchArena, using the global heap when there is no arena
+template <typename T>
+class ArenaAllocator
+{
+public:
+  typedef T value_type;
+
+  ArenaAllocator(SearchArena* arena) noexcept : arena(arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+  T* allocate(std::size_t n)
+  {
+    static_assert(alignof(T) <= SearchArena::GRANULARITY, "Over aligned types cannot be allocated from a SearchArena");
+    return static_cast<T*>(arena ? arena->allocate(n * sizeof(T)) : ::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T* memory, std::size_t n) noexcept
+  {
+    if (arena)
+      arena->deallocate(memory, n * sizeof(T));
+    else
+      ::operator delete(memory);
+  }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other) const noexcept { return arena == other.arena; }
+
+  template <typename U>
+  friend class ArenaAllocator;
+
+private:
+  SearchArena* arena;
+};
+
+//Drop in replacement for std::make_shared that builds the object in the current thread's search arena, if it has one
+//Objects made this way must not be kept once the search that made them has finished
+template <typename T, typename... Args>
+std::shared_ptr<T> makeSearchShared(Args&&... args)
+{
+  return std::allocate_shared<T>(ArenaAllocator<T>(SearchArena::getCurrent()), std::forward<Args>(args)...);
+}
+
+#endif
@@ -0,0 +1,49 @@
+#include "SearchStats.hpp"
+
+#include <cmath>
+
+double SearchStats::getFirstMoveCutoffRate() const
+{
+  if (betaCutoffs == 0 || cutoffsByMoveNumber.empty())
+    return 0.0;
+  return static_cast<double>(cutoffsByMoveNumber[0]) / betaCutoffs;
+}
+
+double SearchStats::getEffectiveBranchingFactor() const
+{
+  if (lazySmp)
+    return 0.0;
+
+  if (iterations.size() >= 2 && iterations[iterations.size() - 2].nodes > 0)
+    return static_cast<double>(iterations.back().nodes) / iterations[iterations.size() - 2].nodes;
+
+  //the root is the only node at ply 0 so the nodes at the deepest ply are the product of the branching factors above it
+  if (nodesPerPly.size() < 2 || nodesPerPly[0] == 0)
+    return 0.0;
+  double growth = static_cast<double>(nodesPerPly.back()) / nodesPerPly[0];
+  return std::pow(growth, 1.0 / (nodesPerPly.size() - 1));
+}
+
+void SearchStats::merge(const SearchStats& other)
+{
+  if (other.nodesPerPly.size() > nodesPerPly.size())
+    nodesPerPly.resize(other.nodesPerPly.size(), 0);
+  for (std::size_t i = 0; i < other.nodesPerPly.size(); ++i)
+    nodesPerPly[i] += other.nodesPerPly[i];
+
+  terminalLeaves += other.terminalLeaves;
+  evaluatedLeaves += other.evaluatedLeaves;
+  transpositionProbes += other.transpositionProbes;
+  transpositionHits += other.transpositionHits;
+  transpositionStores += other.transpositionStores;
+  transpositionCollisions += other.transpositionCollisions;
+  betaCutoffs += other.betaCutoffs;
+  lazySmp = lazySmp || other.lazySmp;
+
+  if (other.cutoffsByMoveNumber.size() > cutoffsByMoveNumber.size())
+    cutoffsByMoveNumber.resize(other.cutoffsByMoveNumber.size(), 0);
+  for (std::size_t i = 0; i < other.cutoffsByMoveNumber.size(); ++i)
+    cutoffsByMoveNumber[i] += other.cutoffsByMoveNumber[i];
+
+  iterations.insert(iterations.end(), other.iterations.begin(), other.iterations.end());
+}
@@ -0,0 +1,116 @@
+#ifndef SEARCH_STATS_H_
+#define SEARCH_STATS_H_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "TranspositionTable.hpp"
+
+//Searches only count into their SearchStats when built with MINIMAX_SEARCH_STATS defined (the CMake option of the same name)
+//otherwise the counting compiles away to nothing and the stats of every search are left empty
+#ifdef MINIMAX_SEARCH_STATS
+constexpr bool SEARCH_STATS_ENABLED = true;
+#else
+constexpr bool SEARCH_STATS_ENABLED = false;
+#endif
+
+//What a MiniMaxSearch did - totals over every thread of the search
+struct SearchStats
+{
+  struct Iteration
+  {
+    int depth;
+    //nodes visited by the iteration - with lazy SMP only the main thread's
+    std::uint64_t nodes;
+    double seconds;
+  };
+
+  //ply 0 is the root
+  std::vector<std::uint64_t> nodesPerPly;
+  std::uint64_t terminalLeaves = 0;
+  std::uint64_t evaluatedLeaves = 0;
+  std::uint64_t transpositionProbes = 0;
+  std::uint64_t transpositionHits = 0;
+  std::uint64_t transpositionStores = 0;
+  //stores which evicted the entry of a different position sharing the bucket
+  std::uint64_t transpositionCollisions = 0;
+  std::uint64_t betaCutoffs = 0;
+  //beta cutoffs by how many moves into the node's move order the move causing it was, counting from 0
+  std::vector<std::uint64_t> cutoffsByMoveNumber;
+  //only the main thread's iterations of an iterative deepening search, or the one fixed depth search
+  std::vector<Iteration> iterations;
+  //set for a lazy SMP search, whose helper threads fill the transposition table the main thread's iterations search with nodes the iterations do not count
+  bool lazySmp = false;
+
+  //fraction of beta cutoffs caused by the first move searched, the usual measure of move ordering quality
+  double getFirstMoveCutoffRate() const;
+  //growth in nodes from the second last iteration to the last, or when there is only one, the average growth from ply to ply
+  //0 for a lazy SMP search, as neither measure means anything when threads at different depths share the work
+  double getEffectiveBranchingFactor() const;
+
+  void merge(const SearchStats& other);
+};
+
+//Counting done by one search thread - the disabled specialisation has no members so every call is removed by the compiler
+template <bool Enabled>
+class SearchStatsCounter;
+
+template <>
+class SearchStatsCounter<true>
+{
+public:
+  void countNode(int ply)
+  {
+    if (ply >= static_cast<int>(stats.nodesPerPly.size()))
+      stats.nodesPerPly.resize(ply + 1, 0);
+    stats.nodesPerPly[ply]++;
+  }
+
+  void countTerminalLeaf() { stats.terminalLeaves++; }
+  void countEvaluatedLeaf() { stats.evaluatedLeaves++; }
+
+  void countTranspositionStore(TranspositionTable::StoreResult result)
+  {
+    if (result == TranspositionTable::StoreResult::KEPT)
+      return;
+    stats.transpositionStores++;
+    if (result == TranspositionTable::StoreResult::REPLACED_OTHER_POSITION)
+      stats.transpositionCollisions++;
+  }
+
+  void countCutoff(std::size_t moveNumber)
+  {
+    stats.betaCutoffs++;
+    if (moveNumber >= stats.cutoffsByMoveNumber.size())
+      stats.cutoffsByMoveNumber.resize(moveNumber + 1, 0);
+    stats.cutoffsByMoveNumber[moveNumber]++;
+  }
+
+  void countIteration(int depth, std::uint64_t nodes, double seconds) { stats.iterations.push_back({depth, nodes, seconds}); }
+
+  const SearchStats& getStats() const { return stats; }
+
+private:
+  SearchStats stats;
+};
+
+template <>
+class SearchStatsCounter<false>
+{
+public:
+  void countNode(int ply) {}
+  void countTerminalLeaf() {}
+  void countEvaluatedLeaf() {}
+  void countTranspositionStore(TranspositionTable::StoreResult result) {}
+  void countCutoff(std::size_t moveNumber) {}
+  void countIteration(int depth, std::uint64_t nodes, double seconds) {}
+
+  const SearchStats& getStats() const
+  {
+    static const SearchStats empty;
+    return empty;
+  }
+};
+
+#endif
@@ -0,0 +1,156 @@
+#include "SearchTrace.hpp"
+
+#include <bit>
+#include <map>
+#include <string>
+#include <iomanip>
+
+namespace
+{
+  const char* getExitName(SearchTrace::Kind kind)
+  {
+    switch (kind)
+    {
+    case SearchTrace::Kind::SEARCHED:
+      return "searched";
+    case SearchTrace::Kind::CUTOFF:
+      return "cutoff";
+    case SearchTrace::Kind::TRANSPOSITION:
+      return "transposition";
+    case SearchTrace::Kind::TERMINAL:
+      return "terminal";
+    case SearchTrace::Kind::LEAF:
+      return "leaf";
+    case SearchTrace::Kind::ABORTED:
+      return "aborted";
+    default:
+      return "enter";
+    }
+  }
+
+  void appendFrameName(std::string& name, const SearchTrace::Event& event)
+  {
+    if (event.ply == 0)
+    {
+      name += "root";
+      return;
+    }
+    //games without move ids can only be named by where the move came in the order the game generated them
+    name += (event.move >= 0) ? "move " : "child ";
+    name += std::to_string((event.move >= 0) ? event.move : event.child);
+  }
+
+  void writeChrome(std::ostream& out, const std::vector<const SearchTrace*>& traces)
+  {
+    std::ios_base::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+    bool first = true;
+    std::string frameName;
+    for (std::size_t thread = 0; thread < traces.size(); ++thread)
+    {
+      out << (first ? "" : ",") << std::endl
+          << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << thread << ", \"args\": {\"name\": \"search thread " << thread << "\"}}";
+      first = false;
+
+      //a full ring can start part way through a node, whose exit is dropped along with those of its ancestors
+      int open = 0;
+      for (const SearchTrace::Event& event : traces[thread]->getEvents())
+      {
+        bool enter = event.kind == SearchTrace::Kind::ENTER;
+        if (!enter && open == 0)
+          continue;
+        open += enter ? 1 : -1;
+
+        frameName.clear();
+        appendFrameName(frameName, event);
+        out << "," << std::endl << "  {\"name\": \"" << frameName << "\", \"cat\": \"search\", \"ph\": \"" << (enter ? "B" : "E")
+            << "\", \"pid\": 0, \"tid\": " << thread << ", \"ts\": " << event.nanoseconds / 1000.0 << ", \"args\": {";
+        if (enter)
+          out << "\"ply\": " << event.ply << ", \"move\": " << event.move << ", \"child\": " << event.child << ", \"alpha\": " << event.alpha << ", \"beta\": " << event.beta;
+        else
+          out << "\"value\": " << event.value << ", \"exit\": \"" << getExitName(event.kind) << "\"";
+        out << "}}";
+      }
+    }
+    out << std::endl << "]}" << std::endl;
+
+    out.flags(flags);
+    out.precision(precision);
+  }
+
+  void writeCollapsed(std::ostream& out, const std::vector<const SearchTrace*>& traces)
+  {
+    struct Frame
+    {
+      std::size_t parentPathLength;
+      std::uint64_t start;
+      std::uint64_t childNanoseconds;
+    };
+
+    //the threads of a search mostly search the same tree so their paths are added together
+    std::map<std::string, std::uint64_t> selfNanoseconds;
+    for (const SearchTrace* trace : traces)
+    {
+      std::string path;
+      std::vector<Frame> frames;
+      for (const SearchTrace::Event& event : trace->getEvents())
+      {
+        if (event.kind == SearchTrace::Kind::ENTER)
+        {
+          //a node below the root with nothing above it has its ancestors on another thread, or lost from a full ring
+          if (frames.empty())
+            path = (event.ply == 0) ? "" : "[ancestors not traced]";
+          frames.push_back({path.size(), event.nanoseconds, 0});
+          if (!path.empty())
+            path += ';';
+          appendFrameName(path, event);
+          continue;
+        }
+
+        if (frames.empty())
+          continue;
+        Frame frame = frames.back();
+        frames.pop_back();
+        std::uint64_t nanoseconds = event.nanoseconds - frame.start;
+        selfNanoseconds[path] += nanoseconds - std::min(frame.childNanoseconds, nanoseconds);
+        path.resize(frame.parentPathLength);
+        if (!frames.empty())
+          frames.back().childNanoseconds += nanoseconds;
+      }
+    }
+
+    for (const auto& [path, nanoseconds] : selfNanoseconds)
+    {
+      if (nanoseconds > 0)
+        out << path << " " << nanoseconds << std::endl;
+    }
+  }
+}
+
+SearchTrace::SearchTrace(std::size_t capacity)
+  : events(std::make_unique<Event[]>(std::bit_ceil(std::max<std::size_t>(capacity, 1)))), mask(std::bit_ceil(std::max<std::size_t>(capacity, 1)) - 1), written(0)
+{
+}
+
+std::vector<SearchTrace::Event> SearchTrace::getEvents() const
+{
+  if (written <= getCapacity())
+    return std::vector<Event>(events.get(), events.get() + written);
+
+  //the oldest event left is the one the next record will overwrite
+  std::size_t oldest = written & mask;
+  std::vector<Event> ordered(events.get() + oldest, events.get() + getCapacity());
+  ordered.insert(ordered.end(), events.get(), events.get() + oldest);
+  return ordered;
+}
+
+void SearchTrace::write(std::ostream& out, Format format, const std::vector<const SearchTrace*>& traces)
+{
+  if (format == Format::CHROME)
+    writeChrome(out, traces);
+  else
+    writeCollapsed(out, traces);
+}
@@ -0,0 +1,193 @@
+#ifndef SEARCH_TRACE_H_
+#define SEARCH_TRACE_H_
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <ostream>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+//Searches only record their nodes into a SearchTrace when built with MINIMAX_SEARCH_TRACE defined (the CMake option of the same name)
+//otherwise the recording compiles away to nothing and the trace of every search is left empty
+#ifdef MINIMAX_SEARCH_TRACE
+constexpr bool SEARCH_TRACE_ENABLED = true;
+#else
+constexpr bool SEARCH_TRACE_ENABLED = false;
+#endif
+
+//The nodes one search thread entered and left, in a ring buffer allocated up front that keeps the newest events once it is full
+//Only its own thread writes to it so recording takes no lock and no atomic, and it is read once the search has finished
+class SearchTrace
+{
+public:
+  static constexpr std::size_t DEFAULT_CAPACITY = 1 << 18;
+
+  enum class Kind : std::uint8_t
+  {
+    ENTER,
+    //the ways of leaving a node
+    SEARCHED,
+    CUTOFF,
+    TRANSPOSITION,
+    TERMINAL,
+    LEAF,
+    ABORTED
+  };
+
+  //alpha and beta are the node's window on entering it and value its result on leaving, all for the side to move at the node
+  //move is the game's id for the move into the node, from SearchableGame::getMoveId or getActionId, and child its index among the parent's children
+  //move is -1 at the root and for games without move ids, and child is -1 at the root
+  struct Event
+  {
+    std::uint64_t nanoseconds;
+    std::int32_t alpha;
+    std::int32_t beta;
+    std::int32_t value;
+    std::int16_t ply;
+    std::int16_t move;
+    std::int16_t child;
+    Kind kind;
+  };
+
+  enum class Format
+  {
+    //trace_event JSON for chrome://tracing or Perfetto, a track for each thread with a slice for each node
+    CHROME,
+    //one line of semicolon separated moves and the nanoseconds spent in that node itself per path, for flamegraph.pl and similar tools
+    //Nodes are named by their move ids, so the same move has the same name whatever order the search tried it in
+    COLLAPSED
+  };
+
+  //capacity is rounded up to a power of two
+  explicit SearchTrace(std::size_t capacity);
+
+  void clear() { written = 0; }
+  void record(const Event& event) { events[written++ & mask] = event; }
+  std::size_t getCapacity() const { return mask + 1; }
+  //Events recorded since the last clear, including any the ring has since overwritten
+  std::uint64_t getRecorded() const { return written; }
+  //The events still in the ring, oldest first
+  std::vector<Event> getEvents() const;
+
+  //Writes the traces of the threads of one search, where traces[i] is thread i's
+  //Nodes entered before the oldest event a full ring kept are left out, and in the collapsed format their descendants go under an [ancestors not traced] frame,
+  //as do the subtrees a thread searched for another thread's node with young brothers wait
+  static void write(std::ostream& out, Format format, const std::vector<const SearchTrace*>& traces);
+
+private:
+  std::unique_ptr<Event[]> events;
+  std::size_t mask;
+  std::uint64_t written;
+};
+
+//Recording done by one search thread - the disabled specialisation has no members so every call is removed by the compiler
+template <bool Enabled>
+class SearchTraceRecorder;
+
+template <>
+class SearchTraceRecorder<true>
+{
+public:
+  //Only every sampleInterval'th subtree rooted at samplePly is recorded, along with every node above samplePly, so a trace of a long search can be kept small
+  void begin(SearchTrace* searchTrace, std::chrono::steady_clock::time_point searchStart, int samplePly, unsigned int sampleInterval)
+  {
+    trace = searchTrace;
+    start = searchStart;
+    sampledPly = samplePly;
+    interval = std::max(sampleInterval, 1u);
+    sampleCount = 0;
+    untracedPly = -1;
+  }
+
+  //Called by a node before searching its child with the id and index of the move into it - the child may be searched more than once
+  void setMove(int ply, int move, int child)
+  {
+    if (ply >= static_cast<int>(moves.size()))
+      moves.resize(ply + 1, {-1, -1});
+    moves[ply] = {static_cast<std::int16_t>(move), static_cast<std::int16_t>(child)};
+  }
+
+  void enter(int ply, int alpha, int beta)
+  {
+    if (trace == nullptr || untracedPly != -1)
+      return;
+    if (ply == sampledPly && sampleCount++ % interval != 0)
+    {
+      untracedPly = ply;
+      return;
+    }
+    record(ply, alpha, beta, 0, SearchTrace::Kind::ENTER);
+  }
+
+  //Returns value so that a node can record leaving as it returns
+  int exit(int ply, int value, SearchTrace::Kind kind)
+  {
+    if (trace == nullptr)
+      return value;
+    if (untracedPly != -1)
+    {
+      if (ply == untracedPly)
+        untracedPly = -1;
+      return value;
+    }
+    record(ply, 0, 0, value, kind);
+    return value;
+  }
+
+  struct Suspended
+  {
+    int untracedPly;
+    std::vector<std::array<std::int16_t, 2>> moves;
+  };
+
+  //A thread which picks up a subtree of another thread's node in the middle of its own search samples the subtree afresh and then carries on where it was
+  Suspended suspend()
+  {
+    Suspended suspended = {untracedPly, moves};
+    untracedPly = -1;
+    return suspended;
+  }
+
+  void resume(Suspended& suspended)
+  {
+    untracedPly = suspended.untracedPly;
+    moves.swap(suspended.moves);
+  }
+
+private:
+  SearchTrace* trace = nullptr;
+  std::chrono::steady_clock::time_point start;
+  int sampledPly = 0;
+  unsigned int interval = 1;
+  std::uint64_t sampleCount = 0;
+  //the ply of the node at the top of the subtree being left out, -1 while recording
+  int untracedPly = -1;
+  //the move id and child index of the move into the node at each ply of the current path
+  std::vector<std::array<std::int16_t, 2>> moves;
+
+  void record(int ply, int alpha, int beta, int value, SearchTrace::Kind kind)
+  {
+    std::uint64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    std::array<std::int16_t, 2> move = (ply > 0 && ply < static_cast<int>(moves.size())) ? moves[ply] : std::array<std::int16_t, 2>{-1, -1};
+    trace->record({nanoseconds, alpha, beta, value, static_cast<std::int16_t>(ply), move[0], move[1], kind});
+  }
+};
+
+template <>
+class SearchTraceRecorder<false>
+{
+public:
+  void begin(SearchTrace* searchTrace, std::chrono::steady_clock::time_point searchStart, int samplePly, unsigned int sampleInterval) {}
+  void setMove(int ply, int move, int child) {}
+  void enter(int ply, int alpha, int beta) {}
+  int exit(int ply, int value, SearchTrace::Kind kind) { return value; }
+  struct Suspended {};
+
+  Suspended suspend() { return {}; }
+  void resume(Suspended& suspended) {}
+};
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef STATIC_MINI_MAX_H_
+#define STATIC_MINI_MAX_H_
+
+#include <array>
+#include <vector>
+#include <utility>
+#include <memory>
+#include <limits.h>
+#include <cstdint>
+#include <cstddef>
+#include <concepts>
+#include <algorithm>
+
+#include "MiniMax.hpp"
+#include "Player.hpp"
+
+//Fixed capacity list of successors so that a game can hand back its children without touching the heap
+template <typename StateType, typename ActionType, std::size_t Capacity>
+class SuccessorList
+{
+public:
+  using value_type = std::pair<StateType, ActionType>;
+
+  void emplace_back(const StateType& state, const ActionType& action) { successors[count++] = value_type(state, action); }
+  std::size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+
+  const value_type* begin() const { return successors.data(); }
+  const value_type* end() const { return successors.data() + count; }
+
+private:
+  std::array<value_type, Capacity> successors;
+  std::size_t count = 0;
+};
+
+//A game searchable at compile time - states and actions are plain value types chosen by the game and every call is resolved statically
+template <typename Game>
+concept StaticSearchableGame = requires(const Game& game, const typename Game::StateType& state, const Player& player)
+{
+  typename Game::StateType;
+  typename Game::ActionType;
+  { game.successorStates(state).begin()->first } -> std::convertible_to<typename Game::StateType>;
+  { game.successorStates(state).begin()->second } -> std::convertible_to<typename Game::ActionType>;
+  { game.terminalState(state) } -> std::convertible_to<bool>;
+  { game.getUtility(state, player) } -> std::convertible_to<int>;
+  { game.getEvaluationValue(state, player) } -> std::convertible_to<int>;
+  { game.getPlayerFromState(state) } -> std::same_as<Player>;
+  { game.getState() } -> std::convertible_to<typename Game::StateType>;
+};
+
+//Exposes a game implementing the virtual SearchableGame interface to StaticMiniMaxSearch
+class SearchableGameAdapter
+{
+public:
+  using StateType = std::shared_ptr<State>;
+  using ActionType = std::shared_ptr<Action>;
+
+  SearchableGameAdapter(const std::shared_ptr<const SearchableGame>& game) : game(game) {}
+
+  std::vector<std::pair<StateType, ActionType>> successorStates(const StateType& state) const { return game->successorStates(state); }
+  bool terminalState(const StateType& state) const { return game->terminalState(state); }
+  int getUtility(const StateType& state, const Player& player) const { return game->getUtility(state, player); }
+  int getEvaluationValue(const StateType& state, const Player& player) const { return game->getEvaluationValue(state, player); }
+  Player getPlayerFromState(const StateType& state) const { return game->getPlayerFromState(state); }
+  StateType getState() const { return game->getState(); }
+
+private:
+  std::shared_ptr<const SearchableGame> game;
+};
+
+template <StaticSearchableGame Game>
+class StaticMiniMaxSearch
+{
+public:
+  using StateType = typename Game::StateType;
+  using ActionType = typename Game::ActionType;
+
+  enum class Options
+  {
+    USE_PRUNING
+  };
+
+  struct ActionValue
+  {
+    ActionType action;
+    int value;
+  };
+
+  StaticMiniMaxSearch(const Game& game) : game(game), player(game.getPlayerFromState(game.getState())), depthLimit(-1), nodesVisited(0) {}
+
+  ActionValue performSearch() { return performSearch(game.getState(), {}, -1); }
+  ActionValue performSearch(const StateType& state) { return performSearch(state, {}, -1); }
+  ActionValue performSearch(const StateType& state, int depth) { return performSearch(state, {}, depth); }
+  ActionValue performSearch(const StateType& state, const std::vector<Options>& options) { return performSearch(state, options, -1); }
+  ActionValue performSearch(const StateType& state, const std::vector<Options>& options, int depth);
+
+  std::uint64_t getNodesVisited() const { return nodesVisited; }
+
+private:
+  Game game;
+  Player player;
+  int depthLimit;
+  std::uint64_t nodesVisited;
+
+  template <bool Maximise, bool Prune>
+  ActionValue value(const StateType& state, int alpha, int beta, int currentDepth);
+};
+
+template <StaticSearchableGame Game>
+typename StaticMiniMaxSearch<Game>::ActionValue StaticMiniMaxSearch<Game>::performSearch(const StateType& state, const std::vector<Options>& options, int depth)
+{
+  player = game.getPlayerFromState(state);
+  depthLimit = depth;
+  nodesVisited = 0;
+
+  ActionValue actionValue;
+  if (std::find(options.begin(), options.end(), Options::USE_PRUNING) != options.end())
+    actionValue = value<true, true>(state, INT_MIN, INT_MAX, 0);
+  else
+    actionValue = value<true, false>(state, INT_MIN, INT_MAX, 0);
+
+  depthLimit = -1;
+  return actionValue;
+}
+
+template <StaticSearchableGame Game>
+template <bool Maximise, bool Prune>
+typename StaticMiniMaxSearch<Game>::ActionValue StaticMiniMaxSearch<Game>::value(const StateType& state, int alpha, int beta, int currentDepth)
+{
+  nodesVisited++;
+  currentDepth++;
+  if (game.terminalState(state))
+    return {ActionType(), game.getUtility(state, player)};
+
+  if (depthLimit != -1)
+    if (currentDepth >= depthLimit)
+      return {ActionType(), game.getEvaluationValue(state, player)};
+
+  ActionValue actionValue;
+  actionValue.action = ActionType();
+  actionValue.value = Maximise ? INT_MIN : INT_MAX;
+
+  for (const auto& successor : game.successorStates(state))
+  {
+    int childValue = value<!Maximise, Prune>(successor.first, alpha, beta, currentDepth).value;
+
+    if (Maximise ? childValue > actionValue.value : childValue < actionValue.value)
+    {
+      actionValue.action = successor.second;
+      actionValue.value = childValue;
+    }
+
+    if constexpr (Prune)
+    {
+      if constexpr (Maximise)
+      {
+        if (actionValue.value >= beta)
+          return actionValue;
+        alpha = std::max(alpha, actionValue.value);
+      }
+      else
+      {
+        if (actionValue.value <= alpha)
+          return actionValue;
+        beta = std::min(beta, actionValue.value);
+      }
+    }
+  }
+
+  return actionValue;
+}
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef STATIC_TIC_TAC_TOE_H_
+#define STATIC_TIC_TAC_TOE_H_
+
+#include "StaticMiniMax.hpp"
+#include "TicTacToeBoard.hpp"
+
+#include <bit>
+
+//TicTacToe rules for StaticMiniMaxSearch - every member is defined inline so the search can be inlined end to end
+class StaticTicTacToe
+{
+public:
+  using StateType = TicTacToeBoard;
+  using ActionType = int;
+
+  StaticTicTacToe() : board() {}
+  StaticTicTacToe(const StateType& board) : board(board) {}
+
+  SuccessorList<StateType, ActionType, 9> successorStates(const StateType& state) const
+  {
+    Player player = state.getPlayerToMove();
+
+    SuccessorList<StateType, ActionType, 9> stateActions;
+    for (std::uint16_t emptyCells = state.emptyCells(); emptyCells; emptyCells &= emptyCells - 1)
+    {
+      int cell = std::countr_zero(emptyCells);
+      StateType possibleState = state;
+      possibleState.place(cell, player);
+      stateActions.emplace_back(possibleState, cell);
+    }
+
+    return stateActions;
+  }
+
+  bool terminalState(const StateType& state) const { return state.checkEndOfGame(); }
+
+  int getUtility(const StateType& state, const Player& player) const
+  {
+    Player oppositePlayer = (player == Player::Player1) ? Player::Player2 : Player::Player1;
+    if (state.checkWinner(player))
+      return 1;
+    if (state.checkWinner(oppositePlayer))
+      return -1;
+
+    return 0;
+  }
+
+  int getEvaluationValue(const StateType& state, const Player& player) const { return getUtility(state, player); }
+  Player getPlayerFromState(const StateType& state) const { return state.getPlayerToMove(); }
+  StateType getState() const { return board; }
+
+private:
+  StateType board;
+};
+
+#endif
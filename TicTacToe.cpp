@@ -1,140 +1,234 @@
 #include "TicTacToe.hpp"
 
 #include <iostream>
-#include <cstring>
-#include <sstream>
+#include <bit>
+#include <algorithm>
 
-bool TicTacToeState::operator==(const std::shared_ptr<State>& rhs) const
-{
-  const std::shared_ptr<TicTacToeState> ticTacState = std::dynamic_pointer_cast<TicTacToeState>(rhs);
-  return board == ticTacState->board;
-}
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
-std::size_t TicTacToeState::getHash() const
+namespace
 {
-  std::hash<std::string> hasher;
-  std::ostringstream stringBuilder;
-  for (char cell : board)
+  //Solutions are indexed by the board read as a number in base 3, each cell a digit that is 0 when empty, 1 for a cross and 2 for a nought
+  constexpr int SOLUTION_COUNT = 19683;
+  constexpr std::array<int, 9> POWERS_OF_THREE = {1, 3, 9, 27, 81, 243, 729, 2187, 6561};
+
+  typedef std::array<TicTacToe::Solution, SOLUTION_COUNT> SolutionTable;
+
+  constexpr int getSolutionIndex(std::uint16_t crosses, std::uint16_t noughts)
   {
-    stringBuilder << cell;
+    int index = 0;
+    for (int cell = 0; cell < 9; ++cell)
+      index += POWERS_OF_THREE[cell] * (((crosses >> cell) & 1) + 2 * ((noughts >> cell) & 1));
+    return index;
   }
-  return hasher(stringBuilder.str());
-}
 
-TicTacToe::TicTacToe()
-{
-  //Initialise player counters
-  playerCounter[Player::Player1] = 'X';
-  playerCounter[Player::Player2] = 'O';
+  //Negamax over every position reachable from the empty board, solving each position once
+  //toMove holds the counters of the player to move, whose cells are digit toMoveDigit in the index
+  constexpr void solvePosition(SolutionTable& solutions, std::uint16_t toMove, std::uint16_t waiting, int index, int toMoveDigit)
+  {
+    if (solutions[index].legal)
+      return;
 
-  //initialise board
-  for (int i = 0; i < 9; ++i)
-    board[i] = '-';
-  
-  currentPlayer = Player::Player1;
-}
+    if (TicTacToeBoard::hasLine(waiting))
+    {
+      solutions[index] = {-1, -1, 0, true};
+      return;
+    }
+    if ((toMove | waiting) == TicTacToeBoard::FULL_BOARD)
+    {
+      solutions[index] = {0, -1, 0, true};
+      return;
+    }
 
-void TicTacToe::makeMove(int cell)
-{
-  if (board[cell] != '-' || cell < 0 || cell > 8)
-    throw TicTacToeInvalidMoveException();
+    TicTacToe::Solution best = {-2, -1, 0, true};
+    for (int cell = 0; cell < 9; ++cell)
+    {
+      if ((toMove | waiting) & (1 << cell))
+        continue;
 
-  board[cell] = playerCounter[currentPlayer];
-  currentPlayer = (currentPlayer == Player::Player1) ? Player::Player2 : Player::Player1;
-}
+      int childIndex = index + toMoveDigit * POWERS_OF_THREE[cell];
+      solvePosition(solutions, waiting, toMove | (1 << cell), childIndex, 3 - toMoveDigit);
+      int value = -solutions[childIndex].value;
+      int movesLeft = solutions[childIndex].movesLeft + 1;
+      if (value > best.value || (value == best.value && ((value > 0 && movesLeft < best.movesLeft) || (value < 0 && movesLeft > best.movesLeft))))
+        best = {static_cast<std::int8_t>(value), static_cast<std::int8_t>(cell), static_cast<std::int8_t>(movesLeft), true};
+    }
+    solutions[index] = best;
+  }
 
-bool TicTacToe::checkEndOfGame(const std::array<char, 9>& board) const
-{
-  if (checkWinner(board, Player::Player1) || checkWinner(board, Player::Player2))
-    return true;
-  
-  for (int i = 0; i < 9; ++i)
+  constexpr SolutionTable solve()
   {
-    if (board[i] == '-')
-      return false;
+    SolutionTable solutions = {};
+    solvePosition(solutions, 0, 0, 0, 1);
+    return solutions;
   }
 
-  return true;
-}
+  constexpr SolutionTable SOLUTIONS = solve();
 
-bool TicTacToe::checkWinner(const std::array<char, 9>& board, const Player player) const
-{
-  char counter = playerCounter.at(player);
+  constexpr std::size_t LINE_BATCH = 16;
+  typedef std::array<std::uint16_t, LINE_BATCH> LineBatch;
 
-  //check rows
-  bool completeRow = false;
-  for (int y = 0; y < 3; ++y)
+  //Sets lines[i] to all ones when boards[i] has every cell of a winning line and to zero otherwise
+  //AVX2 tests all sixteen boards against a line at once, SSE2 eight at a time, and other targets one at a time
+  void findLines(const LineBatch& boards, LineBatch& lines)
   {
-    int  x;
-    for (x = 0; x < 3; ++x)
+#if defined(__AVX2__)
+    __m256i board = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(boards.data()));
+    __m256i found = _mm256_setzero_si256();
+    for (std::uint16_t line : TicTacToeBoard::WIN_MASKS)
     {
-      if (board[y * 3 + x] != counter)
-        break;
+      __m256i mask = _mm256_set1_epi16(static_cast<short>(line));
+      found = _mm256_or_si256(found, _mm256_cmpeq_epi16(_mm256_and_si256(board, mask), mask));
     }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lines.data()), found);
+#elif defined(__SSE2__)
+    for (std::size_t i = 0; i < LINE_BATCH; i += 8)
+    {
+      __m128i board = _mm_loadu_si128(reinterpret_cast<const __m128i*>(boards.data() + i));
+      __m128i found = _mm_setzero_si128();
+      for (std::uint16_t line : TicTacToeBoard::WIN_MASKS)
+      {
+        __m128i mask = _mm_set1_epi16(static_cast<short>(line));
+        found = _mm_or_si128(found, _mm_cmpeq_epi16(_mm_and_si128(board, mask), mask));
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(lines.data() + i), found);
+    }
+#else
+    for (std::size_t i = 0; i < LINE_BATCH; ++i)
+      lines[i] = TicTacToeBoard::hasLine(boards[i]) ? 0xFFFF : 0;
+#endif
+  }
 
-    if (x == 3)
-      return true;
+  constexpr int countLegalPositions()
+  {
+    int count = 0;
+    for (const TicTacToe::Solution& solution : SOLUTIONS)
+      count += solution.legal;
+    return count;
   }
 
-  //check columns
-  bool completeColumn = false;
-  for (int x = 0; x < 3; ++x)
+  //Checks every solved position against its children independently of how solvePosition chose its move - the value must be the best any move gets
+  //and the best cell must be an empty cell which gets it
+  constexpr bool checkSolutions()
   {
-    int  y;
-    for (y = 0; y < 3; ++y)
+    for (int index = 0; index < SOLUTION_COUNT; ++index)
     {
-      if (board[y * 3 + x] != counter)
-        break;
-    }
+      const TicTacToe::Solution& solution = SOLUTIONS[index];
+      if (!solution.legal || solution.bestCell == -1)
+        continue;
 
-    if (y == 3)
-      return true;
-  }
+      std::uint16_t crosses = 0;
+      std::uint16_t noughts = 0;
+      for (int cell = 0, digits = index; cell < 9; ++cell, digits /= 3)
+      {
+        crosses |= (digits % 3 == 1) << cell;
+        noughts |= (digits % 3 == 2) << cell;
+      }
+      int toMoveDigit = (std::popcount(crosses) == std::popcount(noughts)) ? 1 : 2;
 
-  //check diagonals
-  if (board[0] == board[4] && board[4] == board[8] && board[8] == counter)
-    return true;
-  if (board[2] == board[4] && board[4] == board[6] && board[6] == counter)
+      int bestValue = -2;
+      for (int cell = 0; cell < 9; ++cell)
+      {
+        if (!((crosses | noughts) & (1 << cell)))
+          bestValue = std::max(bestValue, -SOLUTIONS[index + toMoveDigit * POWERS_OF_THREE[cell]].value);
+      }
+      if ((crosses | noughts) & (1 << solution.bestCell))
+        return false;
+      if (bestValue != solution.value || -SOLUTIONS[index + toMoveDigit * POWERS_OF_THREE[solution.bestCell]].value != solution.value)
+        return false;
+    }
     return true;
-  
-  return false;
+  }
+
+  static_assert(countLegalPositions() == 5478, "Tic-tac-toe has 5478 legal positions");
+  static_assert(SOLUTIONS[0].value == 0 && SOLUTIONS[0].movesLeft == 9, "Tic-tac-toe is a draw with perfect play");
+  static_assert(SOLUTIONS[getSolutionIndex(0x001, 0x002)].value == 1, "A nought on the edge next to a cross in the corner loses");
+  static_assert(SOLUTIONS[getSolutionIndex(0x003, 0x010)].bestCell == 2, "A nought has to block two crosses in a row");
+  static_assert(SOLUTIONS[getSolutionIndex(0x003, 0x018)].bestCell == 2 && SOLUTIONS[getSolutionIndex(0x003, 0x018)].movesLeft == 1, "A cross takes the win in front of it");
+  static_assert(checkSolutions(), "Every solved position must agree with its children");
+}
+
+bool TicTacToeState::operator==(const std::shared_ptr<State>& rhs) const
+{
+  return board == static_cast<const TicTacToeState&>(*rhs).board;
+}
+
+std::size_t TicTacToeState::getHash() const
+{
+  return board.hash;
+}
+
+int TicTacToeState::mapActionId(int actionId, int symmetry, bool toCanonical) const
+{
+  //action ids are cells
+  return toCanonical ? TicTacToeSymmetry::CELLS[symmetry][actionId] : TicTacToeSymmetry::INVERSE_CELLS[symmetry][actionId];
+}
+
+TicTacToe::TicTacToe()
+{
+  currentPlayer = Player::Player1;
+}
+
+void TicTacToe::makeMove(int cell)
+{
+  if (cell < 0 || cell > 8 || !board.isEmpty(cell))
+    throw TicTacToeInvalidMoveException();
+
+  board.place(cell, currentPlayer);
+  currentPlayer = (currentPlayer == Player::Player1) ? Player::Player2 : Player::Player1;
 }
 
 std::vector<std::pair<std::shared_ptr<State>, std::shared_ptr<Action>>> TicTacToe::successorStates(const std::shared_ptr<State>& state) const
 {
-  std::shared_ptr<TicTacToeState> ticTacToeState = std::dynamic_pointer_cast<TicTacToeState>(state);
-  
-  Player player = getPlayerFromState(state);
-  
+  const TicTacToeBoard& board = static_cast<const TicTacToeState&>(*state).board;
+  Player player = board.getPlayerToMove();
+
   std::vector<std::pair<std::shared_ptr<State>, std::shared_ptr<Action>>> stateActions;
-  for (int i = 0; i < 9; ++i)
+  for (std::uint16_t emptyCells = board.emptyCells(); emptyCells; emptyCells &= emptyCells - 1)
   {
-    if (ticTacToeState->board[i] == '-')
-    {
-      std::shared_ptr<Action> possibleAction = std::make_shared<TicTacToeAction>(i);
-      std::array<char, 9> board = ticTacToeState->board;
-      board[i] = playerCounter.at(player);
-      std::shared_ptr<State> possibleState = std::make_shared<TicTacToeState>(board);
-      stateActions.emplace_back(possibleState, possibleAction);
-    }
+    int cell = std::countr_zero(emptyCells);
+    std::shared_ptr<Action> possibleAction = makeSearchShared<TicTacToeAction>(cell);
+    TicTacToeBoard possibleBoard = board;
+    possibleBoard.place(cell, player);
+    std::shared_ptr<State> possibleState = makeSearchShared<TicTacToeState>(possibleBoard);
+    stateActions.emplace_back(possibleState, possibleAction);
   }
 
   return stateActions;
 }
 
+bool TicTacToe::nextSuccessor(const std::shared_ptr<State>& state, SuccessorCursor& cursor, std::pair<std::shared_ptr<State>, std::shared_ptr<Action>>& successor) const
+{
+  const TicTacToeBoard& board = static_cast<const TicTacToeState&>(*state).board;
+  std::uint16_t remainingCells = board.emptyCells() & ~static_cast<std::uint16_t>(cursor.position);
+  if (remainingCells == 0)
+    return false;
+
+  int cell = std::countr_zero(remainingCells);
+  cursor.position |= 1 << cell;
+
+  TicTacToeBoard possibleBoard = board;
+  possibleBoard.place(cell, board.getPlayerToMove());
+  successor = {makeSearchShared<TicTacToeState>(possibleBoard), makeSearchShared<TicTacToeAction>(cell)};
+  return true;
+}
+
 bool TicTacToe::terminalState(const std::shared_ptr<State>& state) const
 {
-  std::shared_ptr<TicTacToeState> ticTacToeState = std::dynamic_pointer_cast<TicTacToeState>(state);
-  return checkEndOfGame(ticTacToeState->board);
+  return static_cast<const TicTacToeState&>(*state).board.checkEndOfGame();
 }
 
 int TicTacToe::getUtility(const std::shared_ptr<State>& state, const Player& player) const
 {
-  std::shared_ptr<TicTacToeState> ticTacToeState = std::dynamic_pointer_cast<TicTacToeState>(state);
+  const TicTacToeBoard& board = static_cast<const TicTacToeState&>(*state).board;
   Player oppositePlayer = (player == Player::Player1) ? Player::Player2 : Player::Player1;
-  if (checkWinner(ticTacToeState->board, player))
+  if (board.checkWinner(player))
     return 1;
-  if (checkWinner(ticTacToeState->board, oppositePlayer))
+  if (board.checkWinner(oppositePlayer))
     return -1;
   
   return 0;
@@ -142,19 +236,143 @@ int TicTacToe::getUtility(const std::shared_ptr<State>& state, const Player& pla
 
 Player TicTacToe::getPlayerFromState(const std::shared_ptr<State>& state) const
 {
-  std::shared_ptr<TicTacToeState> ticTacToeState = std::dynamic_pointer_cast<TicTacToeState>(state);
-  
-  //determine who the next player to place a counter is
-  int player1Count = 0, player2Count = 0;
-  for (int i = 0; i < 9; ++i)
+  return static_cast<const TicTacToeState&>(*state).board.getPlayerToMove();
+}
+
+int TicTacToe::getActionId(const std::shared_ptr<Action>& action) const
+{
+  return static_cast<const TicTacToeAction&>(*action).cell;
+}
+
+int TicTacToe::getMoveOrderingScore(const std::shared_ptr<State>& state, const std::shared_ptr<Action>& action) const
+{
+  return getMoveScore(state, static_cast<const TicTacToeAction&>(*action).cell);
+}
+
+std::shared_ptr<State> TicTacToe::cloneState(const std::shared_ptr<State>& state) const
+{
+  return makeSearchShared<TicTacToeState>(static_cast<const TicTacToeState&>(*state).board);
+}
+
+std::size_t TicTacToe::generateMoves(const std::shared_ptr<State>& state, MoveBuffer& moves) const
+{
+  std::size_t moveCount = 0;
+  for (std::uint16_t emptyCells = static_cast<const TicTacToeState&>(*state).board.emptyCells(); emptyCells; emptyCells &= emptyCells - 1)
+    moves[moveCount++] = std::countr_zero(emptyCells);
+  return moveCount;
+}
+
+void TicTacToe::makeMove(const std::shared_ptr<State>& state, Move move) const
+{
+  TicTacToeBoard& board = static_cast<TicTacToeState&>(*state).board;
+  board.place(move, board.getPlayerToMove());
+}
+
+void TicTacToe::unmakeMove(const std::shared_ptr<State>& state, Move move) const
+{
+  //the counter being taken off belongs to whoever is not to move now
+  TicTacToeBoard& board = static_cast<TicTacToeState&>(*state).board;
+  board.remove(move, (board.getPlayerToMove() == Player::Player1) ? Player::Player2 : Player::Player1);
+}
+
+std::shared_ptr<Action> TicTacToe::getMoveAction(const std::shared_ptr<State>& state, Move move) const
+{
+  return std::make_shared<TicTacToeAction>(move);
+}
+
+int TicTacToe::getMoveScore(const std::shared_ptr<State>& state, Move move) const
+{
+  //cells on more winning lines are more valuable - the centre is on four, corners on three and edges on two
+  int score = 0;
+  for (std::uint16_t line : TicTacToeBoard::WIN_MASKS)
   {
-    if (ticTacToeState->board[i] == playerCounter.at(Player::Player1))
-      player1Count++;
-    else if (ticTacToeState->board[i] == playerCounter.at(Player::Player2))
-      player2Count++;
+    if (line & (1 << move))
+      score++;
   }
+  return score;
+}
+
+std::size_t TicTacToe::chooseRolloutMove(const std::shared_ptr<State>& state, const MoveBuffer& moves, std::size_t moveCount, std::uint64_t random) const
+{
+  const TicTacToeBoard& board = static_cast<const TicTacToeState&>(*state).board;
+  Player player = board.getPlayerToMove();
+  std::uint16_t own = board.getMask(player);
+  std::uint16_t opponent = board.getMask((player == Player::Player1) ? Player::Player2 : Player::Player1);
+  for (std::uint16_t mask : {own, opponent})
+  {
+    for (std::size_t i = 0; i < moveCount; ++i)
+    {
+      if (TicTacToeBoard::hasLine(mask | (1 << moves[i])))
+        return i;
+    }
+  }
+  return random % moveCount;
+}
+
+void TicTacToe::evaluateBatch(std::span<const std::shared_ptr<State>> states, const Player& player, std::span<int> values) const
+{
+  //the value is the utility, so a board is only worth anything once one side has a line
+  int crossesWin = (player == Player::Player1) ? 1 : -1;
+  for (std::size_t first = 0; first < states.size(); first += LINE_BATCH)
+  {
+    std::size_t count = std::min(LINE_BATCH, states.size() - first);
+    LineBatch crosses = {};
+    LineBatch noughts = {};
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      const TicTacToeBoard& board = static_cast<const TicTacToeState&>(*states[first + i]).board;
+      crosses[i] = board.crosses;
+      noughts[i] = board.noughts;
+    }
 
-  return (player1Count == player2Count) ? Player::Player1 : Player::Player2;
+    LineBatch crossLines;
+    LineBatch noughtLines;
+    findLines(crosses, crossLines);
+    findLines(noughts, noughtLines);
+    for (std::size_t i = 0; i < count; ++i)
+      values[first + i] = crossLines[i] ? crossesWin : noughtLines[i] ? -crossesWin : 0;
+  }
+}
+
+void TicTacToe::evaluateMoveBatch(const std::shared_ptr<State>& state, std::span<const Move> moves, const Player& player, std::span<int> values) const
+{
+  //only the side making the moves can complete a line, unless the other side already has one
+  const TicTacToeBoard& board = static_cast<const TicTacToeState&>(*state).board;
+  Player mover = board.getPlayerToMove();
+  Player waiting = (mover == Player::Player1) ? Player::Player2 : Player::Player1;
+  int moverWins = (player == mover) ? 1 : -1;
+  if (board.checkWinner(waiting))
+  {
+    std::fill(values.begin(), values.begin() + moves.size(), -moverWins);
+    return;
+  }
+
+  std::uint16_t moverCells = board.getMask(mover);
+  for (std::size_t first = 0; first < moves.size(); first += LINE_BATCH)
+  {
+    std::size_t count = std::min(LINE_BATCH, moves.size() - first);
+    LineBatch boards = {};
+    for (std::size_t i = 0; i < count; ++i)
+      boards[i] = moverCells | (1 << moves[first + i]);
+
+    LineBatch lines;
+    findLines(boards, lines);
+    for (std::size_t i = 0; i < count; ++i)
+      values[first + i] = lines[i] ? moverWins : 0;
+  }
+}
+
+TicTacToe::Solution TicTacToe::getSolution(const TicTacToeBoard& board)
+{
+  return SOLUTIONS[getSolutionIndex(board.crosses, board.noughts)];
+}
+
+ActionValue TicTacToe::getOracleMove(const std::shared_ptr<State>& state) const
+{
+  Solution solution = getSolution(static_cast<const TicTacToeState&>(*state).board);
+  if (solution.bestCell == -1)
+    return {nullptr, solution.value};
+  return {std::make_shared<TicTacToeAction>(solution.bestCell), solution.value};
 }
 
 std::shared_ptr<State> TicTacToe::getState() const
@@ -165,13 +383,13 @@ std::shared_ptr<State> TicTacToe::getState() const
 
 void TicTacToe::printState(const std::shared_ptr<State>& state) const
 {
-  std::shared_ptr<TicTacToeState> ticTacToeState = std::dynamic_pointer_cast<TicTacToeState>(state);
+  const TicTacToeBoard& board = static_cast<const TicTacToeState&>(*state).board;
   for (int i = 0; i < 9; ++i)
   {
     if (i % 3 == 0)
       std::cout << std::endl;
     
-    std::cout << ticTacToeState->board[i];
+    std::cout << board.at(i);
   }
   std::cout << std::endl;
 }
@@ -189,7 +407,7 @@ std::ostream& operator<< (std::ostream &out, const TicTacToe& ticTacToeGame)
     if (i % 3 == 0)
       out << std::endl;
     
-    out << ticTacToeGame.board[i] << " ";
+    out << ticTacToeGame.board.at(i) << " ";
   }
 
   return out << std::endl;
@@ -2,18 +2,21 @@
 #define TIC_TAC_TOE_H_
 
 #include "MiniMax.hpp"
+#include "TicTacToeBoard.hpp"
 
-#include <map>
 #include <array>
 
 struct TicTacToeState : public State
 {
-  std::array<char, 9> board;
+  TicTacToeBoard board;
 
+  TicTacToeState(const TicTacToeBoard& board) : board(board) {}
   TicTacToeState(const std::array<char, 9>& board) : board(board) {}
 
   bool operator==(const std::shared_ptr<State>& rhs) const override;
   std::size_t getHash() const override;
+  std::size_t getCanonicalHash(int& symmetry) const override { return board.getCanonicalHash(symmetry); }
+  int mapActionId(int actionId, int symmetry, bool toCanonical) const override;
 };
 
 struct TicTacToeAction : public Action
@@ -33,11 +36,21 @@ public:
     virtual const char* what() const throw() override { return "Cannot move there - must move to empty square"; }
   };
 
+  //A position's value to the player to move when both sides play perfectly - 1 for a win, 0 for a draw and -1 for a loss, as getUtility scores them
+  //bestCell is the move that achieves it, taking the quickest win or the slowest loss, or -1 once the game is over
+  struct Solution
+  {
+    std::int8_t value;
+    std::int8_t bestCell;
+    std::int8_t movesLeft;
+    bool legal;
+  };
+
   TicTacToe();
 
   void makeMove(int cell);
-  bool checkEndOfGame() const { return checkEndOfGame(board); }
-  bool checkWinner(Player player) const { return checkWinner(board, player); };
+  bool checkEndOfGame() const { return board.checkEndOfGame(); }
+  bool checkWinner(Player player) const { return board.checkWinner(player); };
 
   //To implement SearchableGame
   std::vector<std::pair<std::shared_ptr<State>, std::shared_ptr<Action>>> successorStates(const std::shared_ptr<State>& state) const override ;
@@ -45,21 +58,43 @@ public:
   int getUtility(const std::shared_ptr<State>& state, const Player& player) const override;
   Player getPlayerFromState(const std::shared_ptr<State>& state) const override;
   std::shared_ptr<State> getState() const override;
+  //position holds the cells whose successors have already been produced
+  bool nextSuccessor(const std::shared_ptr<State>& state, SuccessorCursor& cursor, std::pair<std::shared_ptr<State>, std::shared_ptr<Action>>& successor) const override;
 
   int getEvaluationValue(const std::shared_ptr<State>& state, const Player& player) const { return getUtility(state, player); };
+  //Evaluate with SSE2, or AVX2 when built with MINIMAX_AVX2, testing every winning line against a batch of boards at once
+  void evaluateBatch(std::span<const std::shared_ptr<State>> states, const Player& player, std::span<int> values) const override;
+  void evaluateMoveBatch(const std::shared_ptr<State>& state, std::span<const Move> moves, const Player& player, std::span<int> values) const override;
+  int getActionId(const std::shared_ptr<Action>& action) const override;
+  int getActionIdCount() const override { return 9; }
+  std::uint64_t getHashFingerprint() const override { return TicTacToeBoard::ZOBRIST_KEYS.getFingerprint(); }
+  int getMoveOrderingScore(const std::shared_ptr<State>& state, const std::shared_ptr<Action>& action) const override;
+
+  //In place moves - a Move is the cell to place the next counter in
+  bool supportsInPlaceMoves() const override { return true; }
+  std::shared_ptr<State> cloneState(const std::shared_ptr<State>& state) const override;
+  std::size_t generateMoves(const std::shared_ptr<State>& state, MoveBuffer& moves) const override;
+  void makeMove(const std::shared_ptr<State>& state, Move move) const override;
+  void unmakeMove(const std::shared_ptr<State>& state, Move move) const override;
+  std::shared_ptr<Action> getMoveAction(const std::shared_ptr<State>& state, Move move) const override;
+  int getMoveId(Move move) const override { return move; }
+  int getMoveScore(const std::shared_ptr<State>& state, Move move) const override;
+  //Rollouts take a win when there is one and otherwise block the opponent's, playing at random when neither comes up
+  std::size_t chooseRolloutMove(const std::shared_ptr<State>& state, const MoveBuffer& moves, std::size_t moveCount, std::uint64_t random) const override;
+
+  //Oracle mode - every position is solved during compilation so these look the answer up instead of searching
+  //getOracleMove gives the same value as a search to the end by MiniMaxSearch
+  static Solution getSolution(const TicTacToeBoard& board);
+  ActionValue getOracleMove(const std::shared_ptr<State>& state) const;
+
   void printState(const std::shared_ptr<State>& state) const override;
   void printAction(const std::shared_ptr<Action>& action) const override;
 
   friend std::ostream& operator<< (std::ostream &out, const TicTacToe& ticTacToeGame);
 
 private:
-  std::array<char, 9> board;
+  TicTacToeBoard board;
   Player currentPlayer;
-
-  std::map<Player, char> playerCounter;
-
-  bool checkEndOfGame(const std::array<char, 9>& board) const;
-  bool checkWinner(const std::array<char, 9>& board, Player player) const;
 };
 
 std::ostream& operator<< (std::ostream &out, const TicTacToe& ticTacToeGame);
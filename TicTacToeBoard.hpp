@@ -0,0 +1,187 @@
+#ifndef TIC_TAC_TOE_BOARD_H_
+#define TIC_TAC_TOE_BOARD_H_
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <climits>
+
+#include "Player.hpp"
+#include "MiniMax.hpp"
+
+namespace TicTacToeSymmetry
+{
+  //Where each cell goes under the eight symmetries of the board - rotations by 0, 90, 180 and 270 degrees, then the same after a reflection in the vertical axis
+  constexpr std::array<std::array<int, 9>, 8> makeCells()
+  {
+    std::array<std::array<int, 9>, 8> cells = {};
+    for (int symmetry = 0; symmetry < 8; ++symmetry)
+    {
+      for (int cell = 0; cell < 9; ++cell)
+      {
+        int row = cell / 3;
+        int column = cell % 3;
+        if (symmetry >= 4)
+          column = 2 - column;
+        for (int rotation = 0; rotation < symmetry % 4; ++rotation)
+        {
+          int rotatedRow = column;
+          column = 2 - row;
+          row = rotatedRow;
+        }
+        cells[symmetry][cell] = row * 3 + column;
+      }
+    }
+    return cells;
+  }
+
+  constexpr std::array<std::array<int, 9>, 8> makeInverseCells(const std::array<std::array<int, 9>, 8>& cells)
+  {
+    std::array<std::array<int, 9>, 8> inverseCells = {};
+    for (int symmetry = 0; symmetry < 8; ++symmetry)
+    {
+      for (int cell = 0; cell < 9; ++cell)
+        inverseCells[symmetry][cells[symmetry][cell]] = cell;
+    }
+    return inverseCells;
+  }
+
+  //masks[symmetry][mask] is the mask with every cell moved by the symmetry, so a whole side of the board is transformed with one lookup
+  constexpr std::array<std::array<std::uint16_t, 512>, 8> makeMasks(const std::array<std::array<int, 9>, 8>& cells)
+  {
+    std::array<std::array<std::uint16_t, 512>, 8> masks = {};
+    for (int symmetry = 0; symmetry < 8; ++symmetry)
+    {
+      for (int mask = 0; mask < 512; ++mask)
+      {
+        for (int cell = 0; cell < 9; ++cell)
+        {
+          if (mask & (1 << cell))
+            masks[symmetry][mask] |= 1 << cells[symmetry][cell];
+        }
+      }
+    }
+    return masks;
+  }
+
+  constexpr std::array<std::array<int, 9>, 8> CELLS = makeCells();
+  constexpr std::array<std::array<int, 9>, 8> INVERSE_CELLS = makeInverseCells(CELLS);
+  constexpr std::array<std::array<std::uint16_t, 512>, 8> MASKS = makeMasks(CELLS);
+}
+
+//Bitboard for a 3x3 board - bit i of each mask is set when that player has a counter in cell i
+struct TicTacToeBoard
+{
+  static constexpr std::uint16_t FULL_BOARD = 0x1FF;
+
+  static constexpr std::array<std::uint16_t, 8> WIN_MASKS = {
+    0x007, 0x038, 0x1C0, //rows
+    0x049, 0x092, 0x124, //columns
+    0x111, 0x054         //diagonals
+  };
+
+  static constexpr ZobristKeys<9, 2> ZOBRIST_KEYS = ZobristKeys<9, 2>();
+
+  std::uint16_t crosses = 0;
+  std::uint16_t noughts = 0;
+  //Zobrist hash of the position - kept up to date by place()
+  std::uint64_t hash = 0;
+
+  constexpr TicTacToeBoard() = default;
+  constexpr TicTacToeBoard(std::uint16_t crosses, std::uint16_t noughts) : crosses(crosses), noughts(noughts), hash(computeHash(crosses, noughts)) {}
+  constexpr TicTacToeBoard(const std::array<char, 9>& cells)
+  {
+    for (int i = 0; i < 9; ++i)
+    {
+      if (cells[i] == 'X')
+        crosses |= 1 << i;
+      else if (cells[i] == 'O')
+        noughts |= 1 << i;
+    }
+    hash = computeHash(crosses, noughts);
+  }
+
+  static constexpr std::uint64_t computeHash(const std::uint16_t crosses, const std::uint16_t noughts)
+  {
+    std::uint64_t hash = 0;
+    for (int i = 0; i < 9; ++i)
+    {
+      if (crosses & (1 << i))
+        hash ^= ZOBRIST_KEYS.get(i, 0);
+      else if (noughts & (1 << i))
+        hash ^= ZOBRIST_KEYS.get(i, 1);
+    }
+    return hash;
+  }
+
+  static constexpr bool hasLine(const std::uint16_t mask)
+  {
+    for (std::uint16_t line : WIN_MASKS)
+    {
+      if ((mask & line) == line)
+        return true;
+    }
+    return false;
+  }
+
+  static constexpr char getCounter(const Player player) { return (player == Player::Player1) ? 'X' : 'O'; }
+
+  constexpr std::uint16_t getMask(const Player player) const { return (player == Player::Player1) ? crosses : noughts; }
+  constexpr std::uint16_t emptyCells() const { return ~(crosses | noughts) & FULL_BOARD; }
+  constexpr bool isEmpty(const int cell) const { return emptyCells() & (1 << cell); }
+  constexpr bool isFull() const { return emptyCells() == 0; }
+
+  constexpr bool checkWinner(const Player player) const { return hasLine(getMask(player)); }
+  constexpr bool checkEndOfGame() const { return isFull() || hasLine(crosses) || hasLine(noughts); }
+
+  //Player1 always moves first so it is their turn whenever both players have placed the same number of counters
+  constexpr Player getPlayerToMove() const { return (std::popcount(crosses) == std::popcount(noughts)) ? Player::Player1 : Player::Player2; }
+
+  constexpr void place(const int cell, const Player player)
+  {
+    if (player == Player::Player1)
+      crosses |= 1 << cell;
+    else
+      noughts |= 1 << cell;
+    hash ^= ZOBRIST_KEYS.get(cell, (player == Player::Player1) ? 0 : 1);
+  }
+
+  //Undoes place()
+  constexpr void remove(const int cell, const Player player)
+  {
+    if (player == Player::Player1)
+      crosses &= ~(1 << cell);
+    else
+      noughts &= ~(1 << cell);
+    hash ^= ZOBRIST_KEYS.get(cell, (player == Player::Player1) ? 0 : 1);
+  }
+
+  //Hash of whichever of the board's eight symmetric orientations has the smallest masks, along with the symmetry that takes the board to it
+  constexpr std::uint64_t getCanonicalHash(int& symmetry) const
+  {
+    std::uint32_t canonical = UINT32_MAX;
+    for (int i = 0; i < 8; ++i)
+    {
+      std::uint32_t transformed = (static_cast<std::uint32_t>(TicTacToeSymmetry::MASKS[i][crosses]) << 9) | TicTacToeSymmetry::MASKS[i][noughts];
+      if (transformed < canonical)
+      {
+        canonical = transformed;
+        symmetry = i;
+      }
+    }
+    return computeHash(canonical >> 9, canonical & FULL_BOARD);
+  }
+
+  constexpr char at(const int cell) const
+  {
+    if (crosses & (1 << cell))
+      return 'X';
+    if (noughts & (1 << cell))
+      return 'O';
+    return '-';
+  }
+
+  constexpr bool operator==(const TicTacToeBoard& rhs) const { return hash == rhs.hash && crosses == rhs.crosses && noughts == rhs.noughts; }
+};
+
+#endif
@@ -0,0 +1,125 @@
+#include "TranspositionTable.hpp"
+
+#include <algorithm>
+
+void TranspositionTable::resize(std::size_t sizeMB)
+{
+  //round down to a power of two number of buckets so a bucket can be selected by masking the key
+  std::size_t maxBuckets = std::max<std::size_t>(sizeMB * 1024 * 1024 / sizeof(Bucket), 1);
+  std::size_t powerOfTwo = 1;
+  while (powerOfTwo * 2 <= maxBuckets)
+    powerOfTwo *= 2;
+
+  buckets.reset(new Bucket[powerOfTwo]);
+  bucketCount = powerOfTwo;
+  indexMask = powerOfTwo - 1;
+  clear();
+}
+
+void TranspositionTable::clear()
+{
+  generation = 0;
+  for (std::size_t i = 0; i < bucketCount; ++i)
+  {
+    for (Slot& slot : buckets[i].slots)
+    {
+      slot.checkedKey.store(0, std::memory_order_relaxed);
+      slot.data.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+bool TranspositionTable::probe(std::uint64_t key, Entry& entry) const
+{
+  for (const Slot& slot : getBucket(key).slots)
+  {
+    std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+    if ((slot.checkedKey.load(std::memory_order_relaxed) ^ data) != key)
+      continue;
+
+    Entry candidate = unpack(key, data);
+    if (candidate.bound != Bound::NONE)
+    {
+      entry = candidate;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+TranspositionTable::StoreResult TranspositionTable::store(std::uint64_t key, int value, int depth, Bound bound, int bestMove)
+{
+  Bucket& bucket = getBucket(key);
+  depth = std::min<int>(depth, MAX_DEPTH);
+
+  //replace the entry for the same position if there is one, otherwise an empty slot, otherwise the entry from the oldest generation, and of those the shallowest
+  Slot* replace = nullptr;
+  Entry replaceEntry = {};
+  for (Slot& slot : bucket.slots)
+  {
+    std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+    Entry candidate = unpack(slot.checkedKey.load(std::memory_order_relaxed) ^ data, data);
+
+    if (candidate.bound != Bound::NONE && candidate.key == key)
+    {
+      //keep a deeper result for the same position unless the new one is exact or the old one is left from an earlier search
+      if (candidate.depth > depth && bound != Bound::EXACT && getAge(candidate) == 0)
+        return StoreResult::KEPT;
+      replace = &slot;
+      replaceEntry = candidate;
+      break;
+    }
+
+    if (replace == nullptr || (replaceEntry.bound != Bound::NONE && (candidate.bound == Bound::NONE || getAge(candidate) > getAge(replaceEntry)
+      || (getAge(candidate) == getAge(replaceEntry) && candidate.depth < replaceEntry.depth))))
+    {
+      replace = &slot;
+      replaceEntry = candidate;
+    }
+  }
+
+  std::uint8_t move = (bestMove >= 0 && bestMove < NO_MOVE) ? static_cast<std::uint8_t>(bestMove) : NO_MOVE;
+  std::uint64_t data = pack(value, depth, bound, move, generation);
+  replace->data.store(data, std::memory_order_relaxed);
+  replace->checkedKey.store(key ^ data, std::memory_order_relaxed);
+
+  return (replaceEntry.bound != Bound::NONE && replaceEntry.key != key) ? StoreResult::REPLACED_OTHER_POSITION : StoreResult::STORED;
+}
+
+std::vector<TranspositionTable::Entry> TranspositionTable::getEntries() const
+{
+  std::vector<Entry> entries;
+  for (std::size_t i = 0; i < bucketCount; ++i)
+  {
+    for (const Slot& slot : buckets[i].slots)
+    {
+      std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+      Entry entry = unpack(slot.checkedKey.load(std::memory_order_relaxed) ^ data, data);
+      if (entry.bound != Bound::NONE)
+        entries.push_back(entry);
+    }
+  }
+  return entries;
+}
+
+std::uint64_t TranspositionTable::pack(int value, int depth, Bound bound, std::uint8_t bestMove, std::uint8_t generation)
+{
+  //the bound takes the low 2 bits of its byte and the generation the other 6
+  return static_cast<std::uint64_t>(static_cast<std::uint32_t>(value))
+    | (static_cast<std::uint64_t>(static_cast<std::uint16_t>(depth)) << 32)
+    | (static_cast<std::uint64_t>(static_cast<std::uint8_t>(bound) | (generation << 2)) << 48)
+    | (static_cast<std::uint64_t>(bestMove) << 56);
+}
+
+TranspositionTable::Entry TranspositionTable::unpack(std::uint64_t key, std::uint64_t data)
+{
+  Entry entry;
+  entry.key = key;
+  entry.value = static_cast<std::int32_t>(static_cast<std::uint32_t>(data));
+  entry.depth = static_cast<std::int16_t>(static_cast<std::uint16_t>(data >> 32));
+  entry.bound = static_cast<Bound>((data >> 48) & 0x3);
+  entry.generation = static_cast<std::uint8_t>((data >> 50) & 0x3F);
+  entry.bestMove = static_cast<std::uint8_t>(data >> 56);
+  return entry;
+}
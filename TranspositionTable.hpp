@@ -0,0 +1,95 @@
+#ifndef TRANSPOSITION_TABLE_H_
+#define TRANSPOSITION_TABLE_H_
+
+#include <array>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+//Fixed size hash table of previously searched positions
+//Memory is allocated once up front from a budget in MB and split into cache line sized buckets of entries
+//Entries are kept from search to search - each search starts a new generation and entries left by earlier generations are the first to be replaced
+//Safe to probe and store from several threads at once without locking - each slot holds the entry packed into one word
+//alongside the key XORed with that word, so a slot torn by two racing stores fails the key check and reads as a miss
+class TranspositionTable
+{
+public:
+  enum class Bound : std::uint8_t
+  {
+    NONE,
+    EXACT,
+    LOWER,
+    UPPER
+  };
+
+  //What a store did to the table - whether it wrote the entry and if so whether that pushed out another position's entry
+  enum class StoreResult
+  {
+    KEPT,
+    STORED,
+    REPLACED_OTHER_POSITION
+  };
+
+  struct Entry
+  {
+    std::uint64_t key;
+    std::int32_t value;
+    std::int16_t depth;
+    Bound bound;
+    std::uint8_t bestMove;
+    std::uint8_t generation;
+  };
+
+  static constexpr std::uint8_t NO_MOVE = 0xFF;
+  static constexpr std::int16_t MAX_DEPTH = INT16_MAX;
+  static constexpr std::size_t DEFAULT_SIZE_MB = 16;
+  //generations are counted modulo this, and share a byte with the bound
+  static constexpr int GENERATIONS = 64;
+
+  TranspositionTable(std::size_t sizeMB = DEFAULT_SIZE_MB) : bucketCount(0), indexMask(0), generation(0) { resize(sizeMB); }
+
+  void resize(std::size_t sizeMB);
+  void clear();
+  //Called at the start of each search - must not be called while the table is being searched
+  void newGeneration() { generation = (generation + 1) % GENERATIONS; }
+  std::uint8_t getGeneration() const { return generation; }
+  bool probe(std::uint64_t key, Entry& entry) const;
+  StoreResult store(std::uint64_t key, int value, int depth, Bound bound, int bestMove);
+  //Every entry in the table - must not be called while the table is being searched
+  std::vector<Entry> getEntries() const;
+
+  std::size_t getBucketCount() const { return bucketCount; }
+  std::size_t getSizeBytes() const { return bucketCount * sizeof(Bucket); }
+
+private:
+  static constexpr std::size_t ENTRIES_PER_BUCKET = 4;
+
+  struct Slot
+  {
+    std::atomic<std::uint64_t> checkedKey;
+    std::atomic<std::uint64_t> data;
+  };
+
+  struct alignas(64) Bucket
+  {
+    std::array<Slot, ENTRIES_PER_BUCKET> slots;
+  };
+
+  std::unique_ptr<Bucket[]> buckets;
+  std::size_t bucketCount;
+  std::uint64_t indexMask;
+  std::uint8_t generation;
+
+  //how many generations ago an entry was stored
+  int getAge(const Entry& entry) const { return (generation - entry.generation + GENERATIONS) % GENERATIONS; }
+
+  static std::uint64_t pack(int value, int depth, Bound bound, std::uint8_t bestMove, std::uint8_t generation);
+  static Entry unpack(std::uint64_t key, std::uint64_t data);
+
+  Bucket& getBucket(std::uint64_t key) { return buckets[key & indexMask]; }
+  const Bucket& getBucket(std::uint64_t key) const { return buckets[key & indexMask]; }
+};
+
+#endif
@@ -0,0 +1,121 @@
+#include "WorkStealingPool.hpp"
+
+#include <chrono>
+
+namespace
+{
+  thread_local const WorkStealingPool* currentPool = nullptr;
+  thread_local int currentWorker = 0;
+}
+
+WorkStealingPool::WorkStealingPool(int threadCount) : queuedTasks(0), shutdown(false)
+{
+  threadCount = std::max(threadCount, 1);
+  for (int i = 0; i < threadCount; ++i)
+    queues.push_back(std::make_unique<TaskQueue>());
+
+  for (int i = 1; i < threadCount; ++i)
+    workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    shutdown.store(true);
+  }
+  wakeUp.notify_all();
+
+  for (std::thread& worker : workers)
+    worker.join();
+}
+
+int WorkStealingPool::getCurrentWorker() const
+{
+  return (currentPool == this) ? currentWorker : 0;
+}
+
+void WorkStealingPool::submit(TaskGroup& group, std::function<void()> task)
+{
+  group.pending.fetch_add(1, std::memory_order_relaxed);
+
+  TaskQueue& queue = *queues[getCurrentWorker()];
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back({std::move(task), &group});
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    queuedTasks.fetch_add(1, std::memory_order_relaxed);
+  }
+  wakeUp.notify_one();
+}
+
+void WorkStealingPool::wait(TaskGroup& group)
+{
+  int index = getCurrentWorker();
+  while (group.pending.load(std::memory_order_acquire) > 0)
+  {
+    if (!tryRunTask(index))
+      std::this_thread::yield();
+  }
+}
+
+void WorkStealingPool::workerLoop(int index)
+{
+  currentPool = this;
+  currentWorker = index;
+
+  while (!shutdown.load())
+  {
+    if (tryRunTask(index))
+      continue;
+
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    wakeUp.wait_for(lock, std::chrono::milliseconds(10), [this]() { return shutdown.load() || queuedTasks.load(std::memory_order_relaxed) > 0; });
+  }
+}
+
+bool WorkStealingPool::tryRunTask(int index)
+{
+  Task task;
+  if (!popTask(index, task))
+    return false;
+
+  task.function();
+  task.group->pending.fetch_sub(1, std::memory_order_release);
+  return true;
+}
+
+bool WorkStealingPool::popTask(int index, Task& task)
+{
+  //newest of our own tasks first as it is the most likely to still be in cache
+  {
+    TaskQueue& queue = *queues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty())
+    {
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+
+  //otherwise steal the oldest task of another thread, which is the root of the largest piece of remaining work
+  for (std::size_t offset = 1; offset < queues.size(); ++offset)
+  {
+    TaskQueue& queue = *queues[(index + offset) % queues.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty())
+    {
+      task = std::move(queue.tasks.front());
+      queue.tasks.pop_front();
+      queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+
+  return false;
+}
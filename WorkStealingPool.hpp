@@ -0,0 +1,70 @@
+#ifndef WORK_STEALING_POOL_H_
+#define WORK_STEALING_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Thread pool where every thread owns a deque of tasks - a thread runs its own newest task first and steals the oldest task of another thread when it runs dry
+//Worker 0 is the single external thread using the pool - it submits work and helps to run tasks while it waits for them
+class WorkStealingPool
+{
+public:
+  //Tasks submitted together so that they can be waited on together
+  class TaskGroup
+  {
+  public:
+    TaskGroup() : pending(0) {}
+
+  private:
+    friend class WorkStealingPool;
+    std::atomic<int> pending;
+  };
+
+  //threadCount includes the external thread so threadCount - 1 background threads are started
+  WorkStealingPool(int threadCount);
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  int getThreadCount() const { return static_cast<int>(queues.size()); }
+  //Index of the calling thread in this pool, 0 for any thread that is not one of its background threads
+  int getCurrentWorker() const;
+
+  void submit(TaskGroup& group, std::function<void()> task);
+  //Runs queued tasks, stealing them if need be, until every task in the group has finished
+  void wait(TaskGroup& group);
+
+private:
+  struct Task
+  {
+    std::function<void()> function;
+    TaskGroup* group;
+  };
+
+  struct alignas(64) TaskQueue
+  {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  std::vector<std::unique_ptr<TaskQueue>> queues;
+  std::vector<std::thread> workers;
+
+  std::atomic<int> queuedTasks;
+  std::atomic<bool> shutdown;
+  std::mutex sleepMutex;
+  std::condition_variable wakeUp;
+
+  void workerLoop(int index);
+  bool tryRunTask(int index);
+  bool popTask(int index, Task& task);
+};
+
+#endif